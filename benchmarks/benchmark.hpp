@@ -0,0 +1,37 @@
+#ifndef SORTVIS_BENCHMARK_HPP
+#define SORTVIS_BENCHMARK_HPP
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+template<typename F>
+[[nodiscard]] auto measure(F&& func) -> double
+{
+    auto const start = std::chrono::steady_clock::now();
+    func();
+    auto const end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+inline auto report(std::string const& name, std::size_t const items, double const seconds) -> void
+{
+    constexpr int name_width = 40;
+    constexpr int number_width = 12;
+    constexpr double million = 1'000'000.0;
+    constexpr double ms_per_s = 1'000.0;
+
+    std::cout << std::left << std::setw(name_width) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(number_width) << seconds * ms_per_s << " ms" << std::setw(number_width)
+              << static_cast<double>(items) / seconds / million << " M/s" << std::endl;
+}
+
+} // namespace bench
+
+#endif // !SORTVIS_BENCHMARK_HPP
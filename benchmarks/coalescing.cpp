@@ -0,0 +1,79 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/random.hpp"
+#include "event/event.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using visual_array = core::basic_array<core::normal_emitter>;
+
+constexpr std::uint64_t g_seed = 42;
+
+// Sorts on a second thread like the visualiser does and drains the queue here.
+auto run(std::string const& name, void (*algorithm)(visual_array&), std::size_t const size, bool const coalescing)
+    -> void
+{
+    std::vector<core::element_t> data(size);
+    std::iota(data.begin(), data.end(), 1);
+    core::random_shuffle(data, g_seed);
+
+    auto& mng = core::event_manager::instance();
+    core::normal_emitter::set_coalescing(coalescing);
+
+    std::size_t events = 0;
+    auto const seconds = bench::measure([&] {
+        visual_array input{ data };
+        std::atomic<bool> sorted{ false };
+        std::thread producer{ [&input, &sorted, algorithm] {
+            algorithm(input);
+            core::normal_emitter::flush();
+            sorted.store(true, std::memory_order_release);
+        } };
+
+        std::array<core::event_data, 1'024> popped{};
+
+        for(;;) {
+            bool const done = sorted.load(std::memory_order_acquire);
+            auto const n = mng.pop(popped.data(), popped.size());
+            events += n;
+
+            if(n == 0) {
+                if(done) {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        producer.join();
+    });
+
+    bench::report(name + (coalescing ? " coalesced" : " raw"), events, seconds);
+    std::cout << "    " << events << " events" << std::endl;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    constexpr std::size_t large = 200'000;
+    constexpr std::size_t small = 5'000;
+
+    for(bool const coalescing : { false, true }) {
+        run("quicksort", &core::algorithm::quicksort<visual_array>, large, coalescing);
+        run("merge_sort", &core::algorithm::merge_sort<visual_array>, large, coalescing);
+        run("insertion_sort", &core::algorithm::insertion_sort<visual_array>, small, coalescing);
+    }
+}
@@ -0,0 +1,211 @@
+#include "benchmark.hpp"
+
+#include "event/event.hpp"
+#include "event/spsc_queue.hpp"
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t g_num_events = 10'000'000;
+constexpr std::size_t g_batch_size = 64;
+
+// The queue `core::event_manager` used before the ring buffer, kept here as the baseline.
+class locked_deque_queue
+{
+    using locked_vector = std::pair<std::deque<core::event_data>, std::mutex>;
+    static constexpr int s_max_events_per_block = 32;
+
+    std::list<locked_vector> m_events;
+
+public:
+    locked_deque_queue()
+    {
+        m_events.emplace_back();
+    }
+
+    auto push(core::event_data const& event) -> void
+    {
+        {
+            std::scoped_lock<std::mutex> lock{ m_events.back().second };
+
+            if(m_events.back().first.size() == s_max_events_per_block) {
+                m_events.emplace_back();
+            }
+        }
+
+        std::scoped_lock<std::mutex> lock{ m_events.back().second };
+        m_events.back().first.push_back(event);
+    }
+
+    auto pop() -> core::event_data
+    {
+        {
+            std::scoped_lock<std::mutex> lock{ m_events.front().second };
+
+            if(m_events.front().first.empty()) {
+                m_events.pop_front();
+            }
+        }
+
+        std::scoped_lock<std::mutex> lock{ m_events.front().second };
+        auto const result = m_events.front().first.front();
+        m_events.front().first.pop_front();
+        return result;
+    }
+
+    auto empty() -> bool
+    {
+        for(auto& event : m_events) {
+            std::scoped_lock<std::mutex> lock{ event.second };
+
+            if(!event.first.empty()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+[[nodiscard]] auto make_event(std::size_t const i) noexcept -> core::event_data
+{
+    return { core::event_type::compare, i, i + 1 };
+}
+
+template<typename Produce, typename Consume>
+auto run(std::string const& name, Produce produce, Consume consume) -> void
+{
+    std::size_t checksum = 0;
+
+    auto const seconds = bench::measure([&] {
+        std::thread producer{ produce };
+        checksum = consume();
+        producer.join();
+    });
+
+    if(checksum != g_num_events) {
+        std::cerr << name << ": events lost or reordered (" << checksum << '/' << g_num_events << ')' << std::endl;
+    }
+
+    bench::report(name, g_num_events, seconds);
+}
+
+auto bench_locked_deque() -> void
+{
+    locked_deque_queue queue;
+
+    run(
+        "locked deque list",
+        [&queue] {
+            for(std::size_t i = 0; i < g_num_events; ++i) {
+                queue.push(make_event(i));
+            }
+        },
+        [&queue] {
+            std::size_t popped = 0;
+
+            while(popped < g_num_events) {
+                if(queue.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                popped += (queue.pop().i == popped) ? 1 : g_num_events;
+            }
+
+            return popped;
+        });
+}
+
+auto bench_spsc(std::size_t const batch) -> void
+{
+    core::spsc_queue<core::event_data> queue{ 1U << 16U };
+
+    run(
+        "spsc ring, batch " + std::to_string(batch),
+        [&queue, batch] {
+            std::array<core::event_data, g_batch_size> events{};
+
+            for(std::size_t i = 0; i < g_num_events; i += batch) {
+                for(std::size_t k = 0; k < batch; ++k) {
+                    events.at(k) = make_event(i + k);
+                }
+
+                for(std::size_t pushed = 0; pushed < batch;) {
+                    auto const n = queue.try_push(events.data() + pushed, batch - pushed);
+
+                    if(n == 0) {
+                        std::this_thread::yield();
+                    }
+
+                    pushed += n;
+                }
+            }
+        },
+        [&queue, batch] {
+            std::array<core::event_data, g_batch_size> events{};
+            std::size_t popped = 0;
+
+            while(popped < g_num_events) {
+                auto const n = queue.try_pop(events.data(), batch);
+
+                if(n == 0) {
+                    std::this_thread::yield();
+                }
+
+                for(std::size_t k = 0; k < n; ++k) {
+                    popped += (events.at(k).i == popped) ? 1 : g_num_events;
+                }
+            }
+
+            return popped;
+        });
+}
+
+auto bench_event_manager() -> void
+{
+    auto& mng = core::event_manager::instance();
+
+    run(
+        "event_manager (push one, pop batch)",
+        [&mng] {
+            for(std::size_t i = 0; i < g_num_events; ++i) {
+                mng.push(make_event(i));
+            }
+        },
+        [&mng] {
+            std::array<core::event_data, g_batch_size> events{};
+            std::size_t popped = 0;
+
+            while(popped < g_num_events) {
+                auto const n = mng.pop(events.data(), events.size());
+
+                if(n == 0) {
+                    std::this_thread::yield();
+                }
+
+                for(std::size_t k = 0; k < n; ++k) {
+                    popped += (events.at(k).i == popped) ? 1 : g_num_events;
+                }
+            }
+
+            return popped;
+        });
+}
+
+} // namespace
+
+auto main() -> int
+{
+    bench_locked_deque();
+    bench_spsc(1);
+    bench_spsc(g_batch_size);
+    bench_event_manager();
+}
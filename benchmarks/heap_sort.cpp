@@ -0,0 +1,67 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "event/event.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t g_seed = 42;
+
+struct heap_variant
+{
+    char const* name;
+    void (*silent)(core::silent_array&);
+    void (*counting)(core::counting_array&);
+};
+
+#define SORTVIS_HEAP_VARIANT(name)                                                                                     \
+    heap_variant                                                                                                       \
+    {                                                                                                                  \
+        #name, &core::algorithm::name<core::silent_array>, &core::algorithm::name<core::counting_array>                \
+    }
+
+auto run(heap_variant const& variant, std::string const& shape, std::vector<core::element_t> const& data) -> void
+{
+    core::silent_array input{ data };
+    auto const seconds = bench::measure([&input, &variant] { variant.silent(input); });
+
+    if(!input.is_sorted()) {
+        std::cerr << variant.name << ": not sorted" << std::endl;
+    }
+
+    core::counting_array counted{ data };
+    core::stats_emitter::reset();
+    variant.counting(counted);
+
+    bench::report(
+        std::string{ variant.name } + ", " + shape + ", " + std::to_string(data.size()), data.size(), seconds);
+    std::cout << "    " << core::stats_emitter::counts().comparisons << " comparisons" << std::endl;
+}
+
+} // namespace
+
+// Elements take 16 bytes, so the smallest array fits in any L2 and the largest in no L3. The binary heap falls
+// behind once a sift misses the cache on every level.
+auto main() -> int
+{
+    for(core::element_t const size : { 10'000U, 1'000'000U, 10'000'000U }) {
+        for(auto const distribution : core::g_distributions) {
+            std::string const input{ core::distribution_name(distribution) };
+            auto const data = core::generate_keys(distribution, size, g_seed);
+
+            for(auto const& variant : { SORTVIS_HEAP_VARIANT(heap_sort), SORTVIS_HEAP_VARIANT(heap_sort_4ary),
+                                        SORTVIS_HEAP_VARIANT(heap_sort_8ary),
+                                        SORTVIS_HEAP_VARIANT(heap_sort_bottom_up) }) {
+                run(variant, input, data);
+            }
+        }
+    }
+}
+
+#undef SORTVIS_HEAP_VARIANT
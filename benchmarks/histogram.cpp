@@ -0,0 +1,97 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "algorithm/histogram.hpp"
+#include "event/event.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t g_size = 10'000'000;
+constexpr std::uint64_t g_seed = 42;
+
+[[nodiscard]] auto level_name(core::simd_level const level) -> std::string
+{
+    switch(level) {
+    case core::simd_level::avx2:
+        return "avx2";
+    case core::simd_level::sse4:
+        return "sse4";
+    case core::simd_level::scalar:
+        break;
+    }
+
+    return "scalar";
+}
+
+// On top of the distributions, nine keys out of ten are the same one, the others are spread over the whole range.
+[[nodiscard]] auto skewed_keys() -> std::vector<core::element_t>
+{
+    constexpr double hot_share = 0.9;
+
+    std::mt19937_64 rng{ g_seed };
+    std::bernoulli_distribution hot{ hot_share };
+    std::uniform_int_distribution<core::element_t> any{ 1, g_size };
+    std::vector<core::element_t> keys(g_size);
+
+    for(auto& key : keys) {
+        key = hot(rng) ? 1 : any(rng);
+    }
+
+    return keys;
+}
+
+auto run(std::string const& input, std::vector<core::element_t> const& keys) -> void
+{
+    core::silent_array const array{ keys };
+
+    for(auto const level : { core::simd_level::scalar, core::simd_level::sse4, core::simd_level::avx2 }) {
+        if(level > core::supported_simd_level()) {
+            continue;
+        }
+
+        core::set_simd_level(level);
+        auto const suffix = ", " + input + ", " + level_name(level);
+
+        core::radix_histogram histogram{};
+        auto seconds = bench::measure([&array, &histogram] {
+            for(core::element_t byte = 0; byte < sizeof(core::element_t); ++byte) {
+                core::byte_histogram(array.data(), array.size(), byte, histogram);
+            }
+        });
+        bench::report("byte_histogram" + suffix, array.size() * sizeof(core::element_t), seconds);
+
+        std::vector<core::element_t> counts(g_size + 1, 0);
+        seconds = bench::measure([&array, &counts] {
+            core::value_histogram(array.data(), array.size(), 0, counts.data());
+        });
+        bench::report("value_histogram" + suffix, array.size(), seconds);
+
+        core::silent_array radix_input{ keys };
+        seconds = bench::measure([&radix_input] { core::algorithm::radix_sort(radix_input); });
+        bench::report("radix_sort" + suffix, keys.size(), seconds);
+
+        core::silent_array count_input{ keys };
+        seconds = bench::measure([&count_input] { core::algorithm::count_sort(count_input); });
+        bench::report("count_sort" + suffix, keys.size(), seconds);
+    }
+
+    core::set_simd_level(core::supported_simd_level());
+}
+
+} // namespace
+
+auto main() -> int
+{
+    for(auto const distribution : core::g_distributions) {
+        run(std::string{ core::distribution_name(distribution) }, core::generate_keys(distribution, g_size, g_seed));
+    }
+
+    run("skewed", skewed_keys());
+}
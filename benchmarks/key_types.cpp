@@ -0,0 +1,73 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "event/event.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr core::element_t g_size = 10'000'000;
+constexpr std::uint64_t g_seed = 42;
+
+template<typename Key>
+auto run(std::string const& name, void (*algorithm)(core::silent_array_of<Key>&), std::vector<Key> const& keys)
+    -> void
+{
+    core::silent_array_of<Key> input{ keys };
+    auto const seconds = bench::measure([&input, algorithm] { algorithm(input); });
+
+    if(!input.is_sorted()) {
+        std::cerr << name << ": not sorted" << std::endl;
+    }
+
+    bench::report(name, keys.size(), seconds);
+}
+
+template<typename Key>
+auto run_all(std::string const& type, std::vector<Key> const& keys) -> void
+{
+    run("pdqsort, " + type, &core::algorithm::pdqsort<core::silent_array_of<Key>>, keys);
+    run("merge_sort_bottom_up, " + type, &core::algorithm::merge_sort_bottom_up<core::silent_array_of<Key>>, keys);
+    run("radix_sort, " + type, &core::algorithm::radix_sort<core::silent_array_of<Key>>, keys);
+    run("american_flag_sort, " + type, &core::algorithm::american_flag_sort<core::silent_array_of<Key>>, keys);
+}
+
+} // namespace
+
+// The same keys as 64 and 32 bit integers, doubles and (key, payload) records, for every distribution. The keys are
+// spread over the whole range of each type, so every byte of them varies. The radix sorts make half as many passes
+// over 32 bit keys.
+auto main() -> int
+{
+    constexpr auto spread = std::numeric_limits<core::element_t>::max() / g_size;
+    constexpr unsigned high_half = 32;
+
+    std::vector<core::element_t> u64(g_size);
+    std::vector<std::uint32_t> u32(g_size);
+    std::vector<double> f64(g_size);
+    std::vector<core::key_value> records(g_size);
+
+    for(auto const distribution : core::g_distributions) {
+        std::string const input{ core::distribution_name(distribution) };
+        auto const keys = core::generate_keys(distribution, g_size, g_seed);
+
+        for(std::size_t i = 0; i < keys.size(); ++i) {
+            u64[i] = keys[i] * spread;
+            u32[i] = static_cast<std::uint32_t>(u64[i] >> high_half);
+            f64[i] = static_cast<double>(u64[i]) - static_cast<double>(std::uint64_t{ 1 } << 63U);
+            records[i] = core::key_value{ u32[i], static_cast<std::uint32_t>(i) };
+        }
+
+        run_all("element_t, " + input, u64);
+        run_all("uint32_t, " + input, u32);
+        run_all("double, " + input, f64);
+        run_all("key_value, " + input, records);
+    }
+}
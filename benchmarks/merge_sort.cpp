@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "event/event.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t g_seed = 42;
+
+std::atomic<std::size_t> g_allocations{ 0 };
+
+auto run(std::string const& name, void (*algorithm)(core::silent_array&), std::vector<core::element_t> const& data)
+    -> void
+{
+    core::silent_array input{ data };
+
+    auto const allocations_before = g_allocations.load(std::memory_order_relaxed);
+    auto const seconds = bench::measure([&input, algorithm] { algorithm(input); });
+    auto const allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+    if(!input.is_sorted()) {
+        std::cerr << name << ": not sorted" << std::endl;
+    }
+
+    bench::report(name + ", " + std::to_string(data.size()), data.size(), seconds);
+    std::cout << "    " << allocations << " allocations" << std::endl;
+}
+
+// Writes per key stand in for memory traffic: every merge pass writes each key once and reads it once. Only writes
+// through the array are counted, `scratch_writes` more are added per counted one for a sort that stages its merges in
+// a plain buffer first.
+auto traffic(std::string const& name,
+             void (*algorithm)(core::counting_array&),
+             std::vector<core::element_t> const& data,
+             std::size_t const scratch_writes = 0) -> void
+{
+    core::counting_array input{ data };
+
+    core::stats_emitter::reset();
+    algorithm(input);
+
+    auto const writes = core::stats_emitter::counts().modifies * (1 + scratch_writes);
+    std::cout << "    " << name << ": " << static_cast<double>(writes) / static_cast<double>(data.size())
+              << " writes per key" << std::endl;
+}
+
+} // namespace
+
+// Every allocation of the process is counted, so the benchmark can tell how many a sort makes.
+auto operator new(std::size_t const size) -> void*
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(void* const memory = std::malloc(size); memory != nullptr) { // NOLINT
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+// kept out of line, inlined into callers GCC would see `free` called on memory from `new`
+[[gnu::noinline]] auto operator delete(void* const memory) noexcept -> void
+{
+    std::free(memory); // NOLINT
+}
+
+[[gnu::noinline]] auto operator delete(void* const memory, std::size_t) noexcept -> void
+{
+    std::free(memory); // NOLINT
+}
+
+auto main() -> int
+{
+    for(core::element_t const size : { 1'000'000U, 10'000'000U }) {
+        for(auto const distribution : core::g_distributions) {
+            std::string const input{ core::distribution_name(distribution) };
+            auto const data = core::generate_keys(distribution, size, g_seed);
+
+            run("merge_sort, " + input, &core::algorithm::merge_sort<core::silent_array>, data);
+            run("merge_sort_bottom_up, " + input, &core::algorithm::merge_sort_bottom_up<core::silent_array>, data);
+            run("multiway_merge_sort, " + input, &core::algorithm::multiway_merge_sort<core::silent_array>, data);
+
+            // merge_sort merges into a vector and copies the result back, one uncounted write per counted one
+            traffic("merge_sort", &core::algorithm::merge_sort<core::counting_array>, data, 1);
+            traffic("merge_sort_bottom_up", &core::algorithm::merge_sort_bottom_up<core::counting_array>, data);
+            traffic("multiway_merge_sort", &core::algorithm::multiway_merge_sort<core::counting_array>, data);
+        }
+    }
+}
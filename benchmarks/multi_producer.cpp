@@ -0,0 +1,111 @@
+#include "benchmark.hpp"
+
+#include "event/event.hpp"
+#include "event/spsc_queue.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t g_num_events = 8'000'000;
+constexpr std::size_t g_batch_size = 256;
+
+// What several sorting threads sharing one queue would look like without per-thread lanes.
+class locked_ring
+{
+    core::spsc_queue<core::event_data> m_events{ 1U << 16U };
+    std::mutex m_lock;
+
+public:
+    auto push(core::event_data const& event) -> void
+    {
+        for(;;) {
+            {
+                std::scoped_lock<std::mutex> lock{ m_lock };
+
+                if(m_events.try_push(event)) {
+                    return;
+                }
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    auto pop(core::event_data* const out, std::size_t const max_count) -> std::size_t
+    {
+        return m_events.try_pop(out, max_count);
+    }
+};
+
+// Every producer pushes its id and a counter, the consumer checks each producer's events arrive in order.
+template<typename Push, typename Pop>
+auto run(std::string const& name, std::size_t const num_producers, Push push, Pop pop) -> void
+{
+    auto const per_producer = g_num_events / num_producers;
+    bool in_order = true;
+
+    auto const seconds = bench::measure([&] {
+        std::vector<std::thread> producers;
+
+        for(std::size_t id = 0; id < num_producers; ++id) {
+            producers.emplace_back([id, per_producer, &push] {
+                for(std::size_t k = 0; k < per_producer; ++k) {
+                    push({ core::event_type::compare, k, id });
+                }
+            });
+        }
+
+        std::vector<std::size_t> next(num_producers, 0);
+        std::array<core::event_data, g_batch_size> events{};
+
+        for(std::size_t popped = 0; popped < per_producer * num_producers;) {
+            auto const n = pop(events.data(), events.size());
+
+            if(n == 0) {
+                std::this_thread::yield();
+            }
+
+            for(std::size_t k = 0; k < n; ++k) {
+                auto const& ev = events.at(k);
+                in_order = in_order && ev.i == next.at(ev.j)++;
+            }
+
+            popped += n;
+        }
+
+        for(auto& t : producers) {
+            t.join();
+        }
+    });
+
+    if(!in_order) {
+        std::cerr << name << ": events reordered" << std::endl;
+    }
+
+    bench::report(name + ", " + std::to_string(num_producers) + " producers", per_producer * num_producers, seconds);
+}
+
+} // namespace
+
+auto main() -> int
+{
+    auto& mng = core::event_manager::instance();
+
+    for(std::size_t const producers : { 1U, 2U, 4U, 8U }) {
+        locked_ring ring;
+
+        run(
+            "mutex + ring", producers, [&ring](core::event_data const& ev) { ring.push(ev); },
+            [&ring](core::event_data* const out, std::size_t const max_count) { return ring.pop(out, max_count); });
+        run(
+            "event_manager", producers, [&mng](core::event_data const& ev) { mng.push(ev); },
+            [&mng](core::event_data* const out, std::size_t const max_count) { return mng.pop(out, max_count); });
+    }
+}
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "algorithm/task_pool.hpp"
+#include "event/event.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr core::element_t g_size = 10'000'000;
+constexpr core::element_t g_radix_size = 100'000'000;
+constexpr std::uint64_t g_seed = 42;
+
+// Times `algorithm` on a silent array, so only the sort itself is measured.
+auto run(std::string const& name, void (*algorithm)(core::silent_array&), std::vector<core::element_t> const& data)
+    -> double
+{
+    core::silent_array input{ data };
+    auto const seconds = bench::measure([&input, algorithm] { algorithm(input); });
+
+    if(!input.is_sorted()) {
+        std::cerr << name << ": not sorted" << std::endl;
+    }
+
+    bench::report(name, data.size(), seconds);
+    return seconds;
+}
+
+// Runs the parallel sort on pools of growing size and prints the speedup over the sequential one.
+auto scale(std::string const& name,
+           void (*sequential)(core::silent_array&),
+           std::string const& parallel_name,
+           void (*parallel)(core::silent_array&),
+           std::vector<core::element_t> const& data) -> void
+{
+    auto const baseline = run(name, sequential, data);
+    auto const max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    for(std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        core::task_pool pool{ threads - 1 };
+        core::task_pool::set_instance(&pool);
+
+        auto const seconds = run(parallel_name + ", " + std::to_string(threads) + " threads", parallel, data);
+        std::cout << "    speedup " << baseline / seconds << std::endl;
+
+        core::task_pool::set_instance(nullptr);
+    }
+}
+
+} // namespace
+
+auto main() -> int
+{
+    for(auto const distribution : core::g_distributions) {
+        std::string const input{ core::distribution_name(distribution) };
+        auto data = core::generate_keys(distribution, g_size, g_seed);
+
+        scale("merge_sort, " + input,
+              &core::algorithm::merge_sort<core::silent_array>,
+              "parallel_merge_sort, " + input,
+              &core::algorithm::parallel_merge_sort<core::silent_array>,
+              data);
+        scale("quicksort, " + input,
+              &core::algorithm::quicksort<core::silent_array>,
+              "parallel_quicksort, " + input,
+              &core::algorithm::parallel_quicksort<core::silent_array>,
+              data);
+        scale("pdqsort, " + input,
+              &core::algorithm::pdqsort<core::silent_array>,
+              "samplesort, " + input,
+              &core::algorithm::samplesort<core::silent_array>,
+              data);
+
+        data = core::generate_keys(distribution, g_radix_size, g_seed);
+
+        scale("radix_sort, " + input,
+              &core::algorithm::radix_sort<core::silent_array>,
+              "parallel_radix_sort, " + input,
+              &core::algorithm::parallel_radix_sort<core::silent_array>,
+              data);
+    }
+}
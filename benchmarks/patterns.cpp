@@ -0,0 +1,47 @@
+#include "benchmark.hpp"
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "event/event.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr core::element_t g_size = 1'000'000;
+constexpr std::uint64_t g_seed = 42;
+
+auto run(std::string const& name, void (*algorithm)(core::silent_array&), std::vector<core::element_t> const& data)
+    -> void
+{
+    core::silent_array input{ data };
+    auto const seconds = bench::measure([&input, algorithm] { algorithm(input); });
+
+    if(!input.is_sorted()) {
+        std::cerr << name << ": not sorted" << std::endl;
+    }
+
+    bench::report(name, data.size(), seconds);
+}
+
+} // namespace
+
+auto main() -> int
+{
+    for(auto const distribution : core::g_distributions) {
+        std::string const input{ core::distribution_name(distribution) };
+        std::vector<core::element_t> data{};
+
+        auto const generate_seconds = bench::measure(
+            [&data, distribution] { data = core::generate_keys(distribution, g_size, g_seed); });
+        bench::report("generate_keys, " + input, data.size(), generate_seconds);
+
+        run("quicksort, " + input, &core::algorithm::quicksort<core::silent_array>, data);
+        run("pdqsort, " + input, &core::algorithm::pdqsort<core::silent_array>, data);
+        run("merge_sort, " + input, &core::algorithm::merge_sort<core::silent_array>, data);
+        run("timsort, " + input, &core::algorithm::timsort<core::silent_array>, data);
+    }
+}
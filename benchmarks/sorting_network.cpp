@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+
+#include "algorithm/distribution.hpp"
+#include "algorithm/sorting_network.hpp"
+#include "event/event.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Keys sorted per run, split in blocks of the size under test.
+constexpr core::element_t g_keys = 1 << 24;
+constexpr std::uint64_t g_seed = 42;
+
+// Sorts each block by moving elements into a hole, what the leaves did before the networks.
+auto insertion_sort(core::element_t* keys, std::size_t const n) -> void
+{
+    for(std::size_t cur = 1; cur < n; ++cur) {
+        auto const value = keys[cur];
+        std::size_t hole = cur;
+
+        for(; hole > 0 && value < keys[hole - 1]; --hole) {
+            keys[hole] = keys[hole - 1];
+        }
+
+        keys[hole] = value;
+    }
+}
+
+template<typename F>
+auto run(std::string const& name, std::vector<core::element_t> const& input, std::size_t const block, F&& sort)
+    -> void
+{
+    auto keys = input;
+    auto const seconds = bench::measure([&keys, block, &sort] {
+        for(std::size_t begin = 0; begin + block <= keys.size(); begin += block) {
+            sort(keys.data() + begin, block);
+        }
+    });
+
+    for(std::size_t begin = 0; begin + block <= keys.size(); begin += block) {
+        if(!std::is_sorted(keys.begin() + std::ptrdiff_t(begin), keys.begin() + std::ptrdiff_t(begin + block))) {
+            std::cerr << name << ": not sorted" << std::endl;
+            return;
+        }
+    }
+
+    bench::report(name + ", blocks of " + std::to_string(block), keys.size(), seconds);
+}
+
+} // namespace
+
+auto main() -> int
+{
+    // the networks compare the same pairs whatever the keys, insertion sort moves as far as the keys are out of order
+    for(auto const distribution : core::g_distributions) {
+        std::string const input{ core::distribution_name(distribution) };
+        auto const keys = core::generate_keys(distribution, g_keys, g_seed);
+
+        for(std::size_t const block : { 4U, 8U, 16U, 24U, 32U }) {
+            run("network_sort, " + input, keys, block, [](core::element_t* k, std::size_t const n) {
+                core::network_sort(k, n);
+            });
+            run("insertion_sort, " + input, keys, block, [](core::element_t* k, std::size_t const n) {
+                insertion_sort(k, n);
+            });
+            run("std::sort, " + input, keys, block, [](core::element_t* k, std::size_t const n) {
+                std::sort(k, k + n);
+            });
+        }
+    }
+}
@@ -1,33 +1,26 @@
 #include "algorithm.hpp"
 #include "event/event.hpp"
+#include "histogram.hpp"
 #include "log/log.hpp"
+#include "loser_tree.hpp"
+#include "sorting_network.hpp"
+#include "task_pool.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
 #include <queue>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace core::algorithm {
 
-auto count_sort(core::array& data) -> void
-{
-    std::vector<core::element_t> frecv(data.size() + 1, 0U);
-
-    for(int i = 0; i < data.isize(); ++i) {
-        ++frecv[data[i].get()];
-    }
-
-    core::element_t index{ 0 };
-    for(core::element_t i = 0; i < frecv.size(); ++i) {
-        for(core::element_t j = 0; j < frecv[i]; ++j) {
-            data[index] = i;
-            data.modify(index, i);
-            ++index;
-        }
-    }
-
-    data.end();
-}
-
-auto bubble_sort(core::array& data) -> void
+template<typename Array>
+auto bubble_sort(Array& data) -> void
 {
     int sorted_offset = 0;
     bool is_sorted = false;
@@ -50,27 +43,59 @@ auto bubble_sort(core::array& data) -> void
     data.end();
 }
 
-[[nodiscard]] constexpr auto nth_byte(element_t const x, element_t const n) -> element_t
+// The histogram kernels read the keys of `element_t` values straight from memory, which only a silent array may
+// bypass events for.
+template<typename Array>
+constexpr bool g_kernel_keys = Array::silent && std::is_same_v<typename Array::key_type, element_t>;
+
+template<typename Array>
+using key_t = typename Array::key_type;
+
+// The network kernels only see copies of the keys, so every silent array can use them.
+template<typename Array>
+constexpr bool g_network_keys = Array::silent;
+
+template<typename Bits>
+[[nodiscard]] constexpr auto nth_byte(Bits const x, element_t const n) -> element_t
 {
     constexpr int byte_size = 8;
     constexpr int byte_max = 0xFF;
-    return (x >> (n * byte_size)) & byte_max;
+    return element_t((x >> (n * byte_size)) & byte_max);
+}
+
+// The highest byte of `x` that isn't zero, 0 if there is none.
+template<typename Bits>
+[[nodiscard]] constexpr auto highest_byte(Bits const x) -> element_t
+{
+    element_t byte = sizeof(Bits) - 1;
+
+    while(byte > 0 && nth_byte(x, byte) == 0) {
+        --byte;
+    }
+
+    return byte;
 }
 
-auto count_sort_helper(core::array const& input, core::array& tmp, core::element_t const byte) -> void
+template<typename Array>
+auto count_sort_helper(Array const& input, Array& tmp, core::element_t const byte) -> void
 {
     constexpr element_t byte_size = 8;
     constexpr element_t max_count = 1 << byte_size; // 2 ^ 8
 
-    auto byte_of = [byte](element_t const num) -> element_t { return nth_byte(num, byte); };
+    auto byte_of = [byte](key_t<Array> const& key) -> element_t { return nth_byte(radix_key(key), byte); };
 
     std::array<element_t, max_count> counter{};
     std::array<element_t, max_count> idx{};
 
     counter.fill(0);
 
-    for(element_t i = 0; i < input.size(); ++i) {
-        ++counter.at(byte_of(input[i].get()));
+    if constexpr(g_kernel_keys<Array>) {
+        byte_histogram(input.data(), input.size(), byte, counter);
+    }
+    else {
+        for(element_t i = 0; i < input.size(); ++i) {
+            ++counter.at(byte_of(input[i].get()));
+        }
     }
 
     idx[0] = 0;
@@ -87,9 +112,10 @@ auto count_sort_helper(core::array const& input, core::array& tmp, core::element
     }
 }
 
-auto radix_sort(core::array& data) -> void
+template<typename Array>
+auto radix_sort(Array& data) -> void
 {
-    core::array tmp{ data }; // NOLINT
+    Array tmp{ data }; // NOLINT
     element_t byte_index{ 0 };
 
     for(;;) {
@@ -98,7 +124,7 @@ auto radix_sort(core::array& data) -> void
         count_sort_helper(data, tmp, byte_index + 2);
         count_sort_helper(tmp, data, byte_index + 3);
 
-        if((byte_index += 4) >= sizeof(element_t)) {
+        if((byte_index += 4) >= sizeof(radix_bits_t<key_t<Array>>)) {
             return;
         }
     }
@@ -106,21 +132,25 @@ auto radix_sort(core::array& data) -> void
     data.end();
 }
 
-auto radix_sort_simple(core::array& data) -> void
+constexpr element_t g_radix_buckets = std::tuple_size_v<radix_histogram>;
+
+template<typename Array>
+auto radix_sort_simple(Array& data) -> void
 {
     constexpr int Base = 10;
-    std::array<std::queue<core::element_t>, Base> digits;
-    core::element_t max = data.size();
-    core::element_t pow{ 1 };
+    std::array<std::queue<key_t<Array>>, Base> digits;
+    radix_bits_t<key_t<Array>> max{ 0 };
 
-    while(max / pow > 0) {
+    for(int i = 0; i < data.isize(); ++i) {
+        max = std::max(max, radix_key(data[i].get()));
+    }
+
+    for(radix_bits_t<key_t<Array>> pow{ 1 };; pow *= Base) {
         // for(int const num : v) {
         for(int i = 0; i < data.isize(); ++i) {
-            digits.at((data[i].get() / pow) % Base).push(data[i].get_raw());
+            digits.at((radix_key(data[i].get()) / pow) % Base).push(data[i].get_raw());
         }
 
-        pow *= Base;
-
         core::element_t index = 0;
         for(core::element_t i = 0; i < Base; ++i) {
             while(!digits.at(i).empty()) {
@@ -129,10 +159,85 @@ auto radix_sort_simple(core::array& data) -> void
                 digits.at(i).pop();
             }
         }
+
+        // the next power could overflow once `max` has as many digits as the type allows
+        if(max / pow < Base) {
+            break;
+        }
+    }
+}
+
+// Ranges smaller than this aren't worth a task of their own.
+constexpr int g_parallel_cutoff = 1 << 13;
+
+// Runs `func` as a task of `group`. The calling thread hands its buffered events over first and the task hands its
+// own over before it counts as finished, so no event shows up before the ones it depends on.
+template<typename Array, typename F>
+auto fork(task_group& group, F&& func) -> void
+{
+    Array::emitter_type::flush();
+    group.run([f = std::forward<F>(func)]() mutable {
+        f();
+        Array::emitter_type::flush();
+    });
+}
+
+// Stores `value` at `i` and lets the emitter know.
+template<typename Array>
+auto assign(Array& v, int const i, key_t<Array> const& value) -> void
+{
+    v[i] = value;
+    v.modify(element_t(i), value);
+}
+
+template<typename Array>
+auto sort2(Array& v, int const a, int const b) -> void
+{
+    if(v[b] < v[a]) {
+        v.swap_at(a, b);
+    }
+}
+
+template<typename Array>
+auto sort3(Array& v, int const a, int const b, int const c) -> void
+{
+    sort2(v, a, b);
+    sort2(v, b, c);
+    sort2(v, a, b);
+}
+
+// Leaves of the recursive sorts at most this long are sorted by a sorting network.
+constexpr int g_network_leaf_size = 16;
+
+// Sorts [begin, end), at most `max_network_size` elements, with a sorting network. A silent array gets the
+// branchless kernel on a copy of its keys, any other one runs every comparator as a compare and maybe a swap.
+template<typename Array>
+auto network_sort_range(Array& v, int const begin, int const end) -> void
+{
+    if constexpr(g_network_keys<Array>) {
+        std::array<key_t<Array>, max_network_size> keys{};
+
+        for(int i = begin; i < end; ++i) {
+            keys[std::size_t(i - begin)] = v[i].get();
+        }
+
+        network_sort(keys.data(), std::size_t(end - begin));
+
+        for(int i = begin; i < end; ++i) {
+            assign(v, i, keys[std::size_t(i - begin)]);
+        }
+    }
+    else {
+        auto const [comparators, count] = network_comparators(std::size_t(end - begin));
+
+        for(std::size_t c = 0; c < count; ++c) {
+            sort2(v, begin + comparators[c].low, begin + comparators[c].high);
+        }
     }
 }
 
-auto median_of_three(core::array& v, int const left, int const right) -> int
+template<typename Array>
+auto median_of_three(Array& v, int const left, int const right) -> int
 {
     int const mid = left + (right - left) / 2;
 
@@ -149,18 +254,11 @@ auto median_of_three(core::array& v, int const left, int const right) -> int
     return mid;
 }
 
-auto quicksort_impl(core::array& v, int const left, int const right) -> void
+// Partitions [left, right], which must hold at least three elements, around the median of three. Leaves
+// [left, j] and [i, right] to be sorted.
+template<typename Array>
+auto hoare_partition(Array& v, int const left, int const right) -> std::pair<int, int>
 {
-    if(right - left <= 0) {
-        return;
-    }
-    if(right - left == 1) {
-        if(v[right] < v[left]) {
-            return v.swap_at(right, left);
-        }
-        return;
-    }
-
     int i{ left };
     int j{ right };
     auto pivot = v[median_of_three(v, left, right)].get();
@@ -178,6 +276,21 @@ auto quicksort_impl(core::array& v, int const left, int const right) -> void
         }
     }
 
+    return { i, j };
+}
+
+template<typename Array>
+auto quicksort_impl(Array& v, int const left, int const right) -> void
+{
+    if(right - left <= 0) {
+        return;
+    }
+    if(right - left < g_network_leaf_size) {
+        return network_sort_range(v, left, right + 1);
+    }
+
+    auto const [i, j] = hoare_partition(v, left, right);
+
     if(j > left) {
         quicksort_impl(v, left, j);
     }
@@ -186,69 +299,2271 @@ auto quicksort_impl(core::array& v, int const left, int const right) -> void
     }
 }
 
-auto quicksort(core::array& data) -> void
+template<typename Array>
+auto quicksort(Array& data) -> void
 {
     quicksort_impl(data, 0, data.isize() - 1);
     data.end();
 }
 
-auto merge(core::array& v, int const left, int const mid, int const right) -> void
+// Ranges shorter than this are insertion sorted.
+constexpr int g_pdq_insertion_sort_threshold = 24;
+// Ranges longer than this take the pivot from the ninther instead of the median of three.
+constexpr int g_pdq_ninther_threshold = 128;
+// An already partitioned range is only insertion sorted if it takes fewer moves than this.
+constexpr int g_pdq_partial_insertion_sort_limit = 8;
+// Elements classified at once by the block partition, the offsets fit in a byte.
+constexpr int g_pdq_block_size = 64;
+
+// Sorts [begin, end) by moving elements into a hole, with `Guarded` false the element before `begin` must not be
+// greater than any in the range.
+template<bool Guarded, typename Array>
+auto pdq_insertion_sort(Array& v, int const begin, int const end) -> void
 {
-    std::vector<core::element_t> tmp;
-    tmp.reserve(std::size_t(right - left) + 1);
+    for(int cur = begin + 1; cur < end; ++cur) {
+        if(!(v[cur] < v[cur - 1])) {
+            continue;
+        }
 
-    int i = left;
-    int j = mid + 1;
+        auto const value = v[cur].get();
+        int hole = cur;
 
-    while(i <= mid && j <= right) {
-        if(v[i] < v[j]) {
-            tmp.push_back(v[i++].get());
+        do {
+            assign(v, hole, v[hole - 1].get());
+            --hole;
+        } while((!Guarded || hole != begin) && value < v[hole - 1].get());
+
+        assign(v, hole, value);
+    }
+}
+
+// Insertion sort that gives up once it moved more than `g_pdq_partial_insertion_sort_limit` elements. Returns
+// whether the range got sorted.
+template<typename Array>
+auto pdq_partial_insertion_sort(Array& v, int const begin, int const end) -> bool
+{
+    int moves = 0;
+
+    for(int cur = begin + 1; cur < end; ++cur) {
+        if(!(v[cur] < v[cur - 1])) {
+            continue;
         }
-        else {
-            tmp.push_back(v[j++].get());
+
+        auto const value = v[cur].get();
+        int hole = cur;
+
+        do {
+            assign(v, hole, v[hole - 1].get());
+            --hole;
+        } while(hole != begin && value < v[hole - 1].get());
+
+        assign(v, hole, value);
+        moves += cur - hole;
+
+        if(moves > g_pdq_partial_insertion_sort_limit) {
+            return false;
         }
     }
 
-    while(i <= mid) {
-        tmp.push_back(v[i++].get());
+    return true;
+}
+
+// Restores the heap property below `root` of the `Arity`-ary max-heap [begin, begin + size), where the children of
+// node `i` are `Arity * i + 1` to `Arity * i + Arity`.
+template<int Arity, typename Array>
+auto sift_down(Array& v, int const begin, int root, int const size) -> void
+{
+    for(;;) {
+        int const first = Arity * root + 1;
+
+        if(first >= size) {
+            return;
+        }
+
+        int const last = std::min(first + Arity, size);
+        int largest = first;
+
+        for(int child = first + 1; child < last; ++child) {
+            largest = (v[begin + largest] < v[begin + child]) ? child : largest;
+        }
+        if(!(v[begin + root] < v[begin + largest])) {
+            return;
+        }
+
+        v.swap_at(begin + root, begin + largest);
+        root = largest;
     }
-    while(j <= right) {
-        tmp.push_back(v[j++].get());
+}
+
+// Slots to leave out before the root of an `Arity`-ary heap starting at `begin`, so that at the array's actual address
+// the children of every node start on a boundary of min(cache line, `Arity` values) (LaMarca and Ladner). Each
+// sift then reads one cache line per level, or `Arity` values' worth of whole lines.
+template<int Arity, typename Array>
+[[nodiscard]] auto heap_alignment_shift(Array const& v, int const begin) -> int
+{
+    constexpr std::size_t value_size = sizeof(typename Array::value_type);
+    constexpr std::size_t group_size = std::min(cache_line_size, Arity * value_size);
+
+    if constexpr(cache_line_size % group_size != 0 || group_size % value_size != 0) {
+        return 0;
     }
+    else {
+        auto const address = reinterpret_cast<std::uintptr_t>(v.data()); // NOLINT
 
-    for(i = left; i <= right; ++i) {
-        v[i] = tmp[std::size_t(i - left)];
-        v.modify(core::element_t(i), tmp[std::size_t(i - left)]);
+        if(address % value_size != 0) {
+            return 0;
+        }
+
+        constexpr std::size_t slots = group_size / value_size;
+        auto const first_child = address / value_size + std::size_t(begin) + 1;
+
+        return int((slots - first_child % slots) % slots);
     }
 }
 
-auto merge_sort_impl(core::array& v, int const left, int const right) -> void
+// Heap sort on an `Arity`-ary heap. A wider heap is shallower, so every sift visits fewer levels, and the children
+// it compares at each level sit next to each other in memory, in as few cache lines as they fit: the heap starts up
+// to a few slots late, and selection puts the smallest keys in those slots first.
+template<int Arity = 2, typename Array>
+auto heap_sort_range(Array& v, int const begin, int const end) -> void
 {
-    if(left < right) {
-        int const mid = left + (right - left) / 2;
-        merge_sort_impl(v, left, mid);
-        merge_sort_impl(v, mid + 1, right);
-        merge(v, left, mid, right);
+    int const shift = std::min(heap_alignment_shift<Arity>(v, begin), end - begin);
+
+    for(int slot = begin; slot < begin + shift; ++slot) {
+        int smallest = slot;
+
+        for(int i = slot + 1; i < end; ++i) {
+            smallest = (v[i] < v[smallest]) ? i : smallest;
+        }
+        if(smallest != slot) {
+            v.swap_at(slot, smallest);
+        }
+    }
+
+    int const root = begin + shift;
+    int const size = end - root;
+
+    for(int node = (size - 2) / Arity; node >= 0; --node) {
+        sift_down<Arity>(v, root, node, size);
+    }
+    for(int last = size - 1; last > 0; --last) {
+        v.swap_at(root, root + last);
+        sift_down<Arity>(v, root, 0, last);
     }
 }
 
-auto merge_sort(core::array& data) -> void
+// Partitions [begin, end) around the pivot at `begin`: smaller elements go left, the others right. Elements are
+// classified a block at a time into offset buffers without branching on the comparisons, then the misplaced ones
+// are swapped pairwise. Returns the pivot's final position and whether the range was already partitioned.
+template<typename Array>
+auto pdq_partition_right(Array& v, int const begin, int const end) -> std::pair<int, bool>
 {
-    merge_sort_impl(data, 0, data.isize() - 1);
-    data.end();
+    int first = begin;
+    int last = end;
+
+    // the pivot selection left an element no less than the pivot at the end, so the first scan stops
+    while(v[++first] < v[begin]) {
+    }
+
+    if(first - 1 == begin) {
+        while(first < last && !(v[--last] < v[begin])) {
+        }
+    }
+    else {
+        while(!(v[--last] < v[begin])) {
+        }
+    }
+
+    bool const already_partitioned = first >= last;
+
+    if(!already_partitioned) {
+        v.swap_at(first, last);
+        ++first;
+
+        std::array<std::uint8_t, g_pdq_block_size> offsets_l{};
+        std::array<std::uint8_t, g_pdq_block_size> offsets_r{};
+        int base_l = first;
+        int base_r = last;
+        int num_l = 0;
+        int num_r = 0;
+        int start_l = 0;
+        int start_r = 0;
+
+        while(first < last) {
+            int const num_unknown = last - first;
+            int const left_split = (num_l == 0) ? ((num_r == 0) ? num_unknown / 2 : num_unknown) : 0;
+            int const right_split = (num_r == 0) ? (num_unknown - left_split) : 0;
+
+            for(int i = 0; i < std::min(left_split, g_pdq_block_size); ++i) {
+                offsets_l[std::size_t(num_l)] = static_cast<std::uint8_t>(i);
+                num_l += !(v[first] < v[begin]);
+                ++first;
+            }
+
+            for(int i = 0; i < std::min(right_split, g_pdq_block_size); ++i) {
+                offsets_r[std::size_t(num_r)] = static_cast<std::uint8_t>(i + 1);
+                num_r += v[--last] < v[begin];
+            }
+
+            int const num = std::min(num_l, num_r);
+
+            for(int k = 0; k < num; ++k) {
+                v.swap_at(base_l + offsets_l[std::size_t(start_l + k)], base_r - offsets_r[std::size_t(start_r + k)]);
+            }
+
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+
+            if(num_l == 0) {
+                start_l = 0;
+                base_l = first;
+            }
+            if(num_r == 0) {
+                start_r = 0;
+                base_r = last;
+            }
+        }
+
+        // at most one side has misplaced elements left, they go next to the boundary
+        while(num_l > 0) {
+            --num_l;
+            v.swap_at(base_l + offsets_l[std::size_t(start_l + num_l)], --last);
+            first = last;
+        }
+        while(num_r > 0) {
+            --num_r;
+            v.swap_at(base_r - offsets_r[std::size_t(start_r + num_r)], first++);
+            last = first;
+        }
+    }
+
+    int const pivot_pos = first - 1;
+    v.swap_at(begin, pivot_pos);
+
+    return { pivot_pos, already_partitioned };
 }
 
-auto insertion_sort(core::array& data) -> void
+// Partitions [begin, end) around the pivot at `begin` with the elements equal to it going left. Used when the
+// pivot equals the element before the range, then the left part needs no further sorting.
+template<typename Array>
+auto pdq_partition_left(Array& v, int const begin, int const end) -> int
 {
-    for(int i = 1; i < data.isize(); ++i) {
-        int j = i - 1;
-        while(j >= 0 && data[j] > data[j + 1]) {
-            data.swap_at(j, j + 1);
-            --j;
+    int first = begin;
+    int last = end;
+
+    while(v[begin] < v[--last]) {
+    }
+
+    if(last + 1 == end) {
+        while(first < last && !(v[begin] < v[++first])) {
+        }
+    }
+    else {
+        while(!(v[begin] < v[++first])) {
+        }
+    }
+
+    while(first < last) {
+        v.swap_at(first, last);
+
+        while(v[begin] < v[--last]) {
+        }
+        while(!(v[begin] < v[++first])) {
+        }
+    }
+
+    v.swap_at(begin, last);
+    return last;
+}
+
+// Swaps a few elements of a range the partition left badly unbalanced, so the next pivot is unlikely to be as bad.
+template<typename Array>
+auto pdq_break_patterns(Array& v, int const begin, int const end) -> void
+{
+    int const size = end - begin;
+    int const quarter = size / 4;
+
+    if(size < g_pdq_insertion_sort_threshold) {
+        return;
+    }
+
+    v.swap_at(begin, begin + quarter);
+    v.swap_at(end - 1, end - quarter);
+
+    if(size > g_pdq_ninther_threshold) {
+        v.swap_at(begin + 1, begin + (quarter + 1));
+        v.swap_at(begin + 2, begin + (quarter + 2));
+        v.swap_at(end - 2, end - (quarter + 1));
+        v.swap_at(end - 3, end - (quarter + 2));
+    }
+}
+
+template<typename Array>
+auto pdqsort_loop(Array& v, int begin, int const end, int bad_allowed, bool leftmost) -> void
+{
+    for(;;) {
+        int const size = end - begin;
+
+        if(size < g_pdq_insertion_sort_threshold) {
+            if(leftmost) {
+                pdq_insertion_sort<true>(v, begin, end);
+            }
+            else {
+                pdq_insertion_sort<false>(v, begin, end);
+            }
+
+            return;
+        }
+
+        // the median ends up at `begin`, and an element no less than it at `end - 1`
+        int const half = size / 2;
+
+        if(size > g_pdq_ninther_threshold) {
+            sort3(v, begin, begin + half, end - 1);
+            sort3(v, begin + 1, begin + (half - 1), end - 2);
+            sort3(v, begin + 2, begin + (half + 1), end - 3);
+            sort3(v, begin + (half - 1), begin + half, begin + (half + 1));
+            v.swap_at(begin, begin + half);
+        }
+        else {
+            sort3(v, begin + half, begin, end - 1);
+        }
+
+        // many equal elements: put all the ones equal to the pivot left and skip them
+        if(!leftmost && !(v[begin - 1] < v[begin])) {
+            begin = pdq_partition_left(v, begin, end) + 1;
+            continue;
+        }
+
+        auto const [pivot_pos, already_partitioned] = pdq_partition_right(v, begin, end);
+        int const left_size = pivot_pos - begin;
+        int const right_size = end - (pivot_pos + 1);
+
+        if(left_size < size / 8 || right_size < size / 8) {
+            // too many bad pivots, the heap sort bounds the worst case at O(n log n)
+            if(--bad_allowed == 0) {
+                heap_sort_range(v, begin, end);
+                return;
+            }
+
+            pdq_break_patterns(v, begin, pivot_pos);
+            pdq_break_patterns(v, pivot_pos + 1, end);
+        }
+        else if(already_partitioned && pdq_partial_insertion_sort(v, begin, pivot_pos) &&
+                pdq_partial_insertion_sort(v, pivot_pos + 1, end)) {
+            // no swaps were needed, the range was likely (nearly) sorted already
+            return;
         }
+
+        pdqsort_loop(v, begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template<typename Array>
+auto pdqsort_range(Array& v, int const begin, int const end) -> void
+{
+    int bad_allowed = 0;
+
+    for(int size = end - begin; size > 1; size >>= 1) {
+        ++bad_allowed;
+    }
+
+    if(end - begin > 1) {
+        pdqsort_loop(v, begin, end, bad_allowed, true);
     }
+}
 
+// Pattern-defeating quicksort: an introsort that recognizes sorted runs and many equal keys, and breaks up the
+// patterns that make quicksort pick bad pivots.
+template<typename Array>
+auto pdqsort(Array& data) -> void
+{
+    pdqsort_range(data, 0, data.isize());
     data.end();
 }
 
+// Partitions larger than this are split between all threads of the pool.
+constexpr int g_parallel_partition_cutoff = 1 << 20;
+
+// Block-based parallel partition of [left, right]: every block is partitioned on its own, then the elements that
+// ended up on the wrong side of the final boundary are swapped across it in parallel. Returns the boundary, [left,
+// mid) holds the elements less than the median of three.
+template<typename Array>
+auto parallel_partition(Array& v, int const left, int const right) -> int
+{
+    task_group group{ task_pool::instance() };
+    auto const pivot = v[median_of_three(v, left, right)].get();
+    auto const num_blocks = static_cast<int>(std::max<std::size_t>(task_pool::instance().concurrency(), 2));
+    int const block_size = (right - left) / num_blocks + 1;
+
+    std::vector<int> less_counts(std::size_t(num_blocks), 0);
+
+    for(int b = 0; b < num_blocks; ++b) {
+        fork<Array>(group, [&v, &less_counts, pivot, b, begin = left + b * block_size,
+                            end = std::min(right + 1, left + (b + 1) * block_size)] {
+            int lo = begin;
+            int hi = end - 1;
+
+            for(;;) {
+                while(lo <= hi && v[lo].get() < pivot) {
+                    ++lo;
+                }
+                while(lo <= hi && !(v[hi].get() < pivot)) {
+                    --hi;
+                }
+                if(lo >= hi) {
+                    break;
+                }
+
+                v.swap_at(lo++, hi--);
+            }
+
+            less_counts[std::size_t(b)] = lo - begin;
+        });
+    }
+
+    group.wait();
+
+    int mid = left;
+
+    for(int const count : less_counts) {
+        mid += count;
+    }
+
+    // greater elements left of the boundary and less ones right of it, there are as many of each
+    std::vector<int> move_right;
+    std::vector<int> move_left;
+
+    for(int b = 0; b < num_blocks; ++b) {
+        int const begin = left + b * block_size;
+        int const end = std::min(right + 1, begin + block_size);
+        int const split = begin + less_counts[std::size_t(b)];
+
+        for(int k = std::max(split, begin); k < std::min(end, mid); ++k) {
+            move_right.push_back(k);
+        }
+        for(int k = std::max(begin, mid); k < std::min(split, end); ++k) {
+            move_left.push_back(k);
+        }
+    }
+
+    ASSERT(move_right.size() == move_left.size());
+    auto const num_moves = static_cast<int>(move_right.size());
+
+    for(int begin = 0; begin < num_moves; begin += g_parallel_cutoff) {
+        fork<Array>(group, [&v, &move_right, &move_left, begin, end = std::min(num_moves, begin + g_parallel_cutoff)] {
+            for(int k = begin; k < end; ++k) {
+                v.swap_at(move_right[std::size_t(k)], move_left[std::size_t(k)]);
+            }
+        });
+    }
+
+    group.wait();
+    return mid;
+}
+
+template<typename Array>
+auto parallel_quicksort_impl(Array& v, int left, int right, task_group& group) -> void
+{
+    while(right - left > g_parallel_cutoff) {
+        int i = 0;
+        int j = 0;
+
+        if(right - left > g_parallel_partition_cutoff && task_pool::instance().concurrency() > 1) {
+            i = parallel_partition(v, left, right);
+            j = i - 1;
+        }
+        if(i <= left) {
+            // nothing was less than the pivot, the sequential partition always makes progress
+            std::tie(i, j) = hoare_partition(v, left, right);
+        }
+
+        // the larger side becomes a task for idle threads to steal, this thread carries on with the smaller one
+        if(j - left > right - i) {
+            fork<Array>(group, [&v, left, j, &group] { parallel_quicksort_impl(v, left, j, group); });
+            left = i;
+        }
+        else {
+            fork<Array>(group, [&v, i, right, &group] { parallel_quicksort_impl(v, i, right, group); });
+            right = j;
+        }
+    }
+
+    quicksort_impl(v, left, right);
+}
+
+template<typename Array>
+auto parallel_quicksort(Array& data) -> void
+{
+    task_group group{ task_pool::instance() };
+
+    parallel_quicksort_impl(data, 0, data.isize() - 1, group);
+    group.wait();
+    data.end();
+}
+
+// Ranges up to this long are left to pdqsort by the samplesort.
+constexpr int g_sample_base_case = 1 << 12;
+// A samplesort step splits a range into at most 2 ^ this many buckets, twice as many with equality buckets.
+constexpr int g_sample_max_log_buckets = 8;
+// Keys are moved between the buffers and the array in blocks of this many bytes.
+constexpr std::size_t g_sample_block_bytes = 1024;
+
+template<typename Key>
+constexpr int g_sample_block_size = int(std::max<std::size_t>(1, g_sample_block_bytes / sizeof(Key)));
+
+// Finds the bucket of a key by descending an implicit binary search tree of splitters, one comparison per level
+// whose result becomes the next index instead of a branch. With equality buckets every splitter gets a bucket of
+// its own for the keys equal to it, those need no further sorting.
+template<typename Key>
+class sample_classifier
+{
+private:
+    static constexpr int s_max_buckets = 1 << g_sample_max_log_buckets;
+
+    // node i has children 2i and 2i + 1, the root is 1
+    std::array<Key, s_max_buckets> m_tree{};
+    std::array<Key, s_max_buckets> m_splitters{};
+    int m_log_buckets{ 0 };
+    int m_num_splitters{ 0 };
+    bool m_equality{ false };
+
+    auto build(int const node, int const low, int const high) -> void
+    {
+        if(node >= (1 << m_log_buckets)) {
+            return;
+        }
+
+        int const mid = low + (high - low) / 2;
+        m_tree[std::size_t(node)] = m_splitters[std::size_t(mid)];
+        this->build(2 * node, low, mid);
+        this->build(2 * node + 1, mid + 1, high);
+    }
+
+public:
+    // `splitters` are sorted and distinct, the buckets are padded to a power of two with empty ones.
+    sample_classifier(std::vector<Key> const& splitters, int const log_buckets, bool const equality)
+        : m_log_buckets{ log_buckets }
+        , m_num_splitters{ int(splitters.size()) }
+        , m_equality{ equality }
+    {
+        int const padded = (1 << log_buckets) - 1;
+
+        for(int i = 0; i < padded; ++i) {
+            m_splitters[std::size_t(i)] = splitters[std::size_t(std::min(i, m_num_splitters - 1))];
+        }
+
+        this->build(1, 0, padded);
+    }
+
+    [[nodiscard]] auto num_buckets() const noexcept -> int
+    {
+        return (1 << m_log_buckets) << int(m_equality);
+    }
+
+    [[nodiscard]] auto is_equality_bucket(int const bucket) const noexcept -> bool
+    {
+        return m_equality && bucket % 2 == 1;
+    }
+
+    [[nodiscard]] auto classify(Key const& key) const noexcept -> int
+    {
+        int node = 1;
+
+        for(int level = 0; level < m_log_buckets; ++level) {
+            node = 2 * node + int(m_tree[std::size_t(node)] < key);
+        }
+
+        int const bucket = node - (1 << m_log_buckets);
+
+        if(!m_equality) {
+            return bucket;
+        }
+
+        return 2 * bucket + int(bucket < m_num_splitters && !(key < m_splitters[std::size_t(bucket)]));
+    }
+};
+
+// Moves a random sample of [begin, end) to its front, sorts it and picks equidistant splitters from it. Equality
+// buckets are used once the sample holds repeated splitters.
+template<typename Array>
+[[nodiscard]] auto sample_splitters(Array& v, int const begin, int const end) -> sample_classifier<key_t<Array>>
+{
+    int const size = end - begin;
+    int log_size = 0;
+
+    while((size >> log_size) > 1) {
+        ++log_size;
+    }
+
+    int log_buckets = 2;
+
+    while(log_buckets < g_sample_max_log_buckets && (size >> (log_buckets + 1)) >= g_sample_base_case) {
+        ++log_buckets;
+    }
+
+    // IPS4o takes about 0.2 log n keys per bucket
+    int const oversampling = std::max(1, log_size / 5);
+    int const sample_size = std::min(size / 2, oversampling << log_buckets);
+
+    std::minstd_rand rng{ std::uint32_t(size) };
+
+    for(int i = 0; i < sample_size; ++i) {
+        std::uniform_int_distribution<int> pick{ i, size - 1 };
+        v.swap_at(begin + i, begin + pick(rng));
+    }
+
+    pdqsort_range(v, begin, begin + sample_size);
+
+    std::vector<key_t<Array>> splitters;
+    int const step = sample_size >> log_buckets;
+
+    for(int i = 1; i < (1 << log_buckets); ++i) {
+        auto const key = v[begin + std::max(0, i * step - 1)].get();
+
+        if(splitters.empty() || splitters.back() < key) {
+            splitters.push_back(key);
+        }
+    }
+
+    bool const equality = int(splitters.size()) < (1 << log_buckets) - 1;
+
+    return sample_classifier<key_t<Array>>{ splitters, log_buckets, equality };
+}
+
+// Distributes [begin, end) into the buckets of `classifier` in place and returns where each bucket begins, with the
+// end of the range last. Every step runs on all threads, after IPS4o:
+//
+// Every thread classifies a stripe of the range into one buffer block per bucket, and writes full blocks back to
+// the front of its stripe. The few full blocks past the end of all of them are moved to the gaps the stripes left
+// in front of that, which packs the full blocks at the front. Each bucket gets a region of whole blocks starting
+// where the bucket starts, rounded down to a block boundary. Then every thread starts at a bucket of its own and
+// takes blocks still to be placed out of it, carrying each one to its bucket's region and swapping it with the next
+// block there that is still to be placed, until one lands in an empty slot. At last the keys a bucket's first block
+// put in front of where the bucket starts, and the ones left in the buffers, fill up what's left of every bucket.
+// Besides the array this only takes a few blocks per bucket and thread.
+template<typename Array>
+auto sample_distribute(Array& v, int const begin, int const end, sample_classifier<key_t<Array>> const& classifier)
+    -> std::vector<int>
+{
+    using key = key_t<Array>;
+
+    constexpr int block = g_sample_block_size<key>;
+
+    struct stripe
+    {
+        int begin;
+        int end;
+        int write;
+        std::vector<key> buffers;
+        std::vector<int> fill;
+        std::vector<int> count; // keys per bucket
+    };
+
+    // [region begin, write) holds blocks of the bucket, [write, read) blocks that are still to be placed and
+    // [read, next region begin) nothing
+    struct bucket_pointers
+    {
+        std::mutex lock{};
+        int write{ 0 };
+        int read{ 0 };
+    };
+
+    auto& pool = task_pool::instance();
+    int const size = end - begin;
+    int const num_buckets = classifier.num_buckets();
+    int const num_stripes = std::clamp(size / g_parallel_cutoff, 1, int(pool.concurrency()));
+    // whole blocks, so the full blocks of every stripe line up with the regions of the buckets
+    int const stripe_size = ((size + num_stripes - 1) / num_stripes + block - 1) / block * block;
+    std::vector<stripe> stripes;
+
+    for(int s = 0; s < num_stripes; ++s) {
+        int const stripe_begin = begin + std::min(size, s * stripe_size);
+
+        stripes.push_back(stripe{ stripe_begin,
+                                  std::min(end, stripe_begin + stripe_size),
+                                  stripe_begin,
+                                  std::vector<key>(std::size_t(num_buckets * block)),
+                                  std::vector<int>(std::size_t(num_buckets), 0),
+                                  std::vector<int>(std::size_t(num_buckets), 0) });
+    }
+
+    task_group group{ pool };
+
+    // Runs `f(s)` for every stripe index in parallel.
+    auto for_each_stripe = [&group, num_stripes](auto const& f) {
+        for(int s = 0; s < num_stripes; ++s) {
+            fork<Array>(group, [&f, s] { f(s); });
+        }
+
+        group.wait();
+    };
+
+    for_each_stripe([&v, &classifier, &stripes](int const index) {
+        auto& s = stripes[std::size_t(index)];
+
+        for(int i = s.begin; i < s.end; ++i) {
+            auto const value = v[i].get();
+            auto const bucket = classifier.classify(value);
+            auto& fill = s.fill[std::size_t(bucket)];
+
+            ++s.count[std::size_t(bucket)];
+            s.buffers[std::size_t(bucket * block + fill++)] = value;
+
+            // at least a block more was read than written, so this never overwrites an unread key
+            if(fill == block) {
+                for(int k = 0; k < block; ++k) {
+                    assign(v, s.write++, s.buffers[std::size_t(bucket * block + k)]);
+                }
+
+                fill = 0;
+            }
+        }
+    });
+
+    std::vector<int> bucket_begin(std::size_t(num_buckets) + 1, begin);
+    std::vector<int> region_begin(std::size_t(num_buckets) + 1, begin);
+    int full_end = begin;
+
+    for(int b = 0; b < num_buckets; ++b) {
+        bucket_begin[std::size_t(b) + 1] = bucket_begin[std::size_t(b)];
+
+        for(auto const& s : stripes) {
+            bucket_begin[std::size_t(b) + 1] += s.count[std::size_t(b)];
+        }
+
+        region_begin[std::size_t(b) + 1] = begin + (bucket_begin[std::size_t(b) + 1] - begin) / block * block;
+    }
+
+    for(auto const& s : stripes) {
+        full_end += s.write - s.begin;
+    }
+
+    // Only a stripe's unfilled end can be a gap, so there are at most as many as blocks of buffers.
+    std::vector<int> gaps;
+    std::vector<int> strays;
+
+    for(auto const& s : stripes) {
+        for(int i = s.write; i < std::min(s.end, full_end); i += block) {
+            gaps.push_back(i);
+        }
+        for(int i = std::max(s.begin, full_end); i < s.write; i += block) {
+            strays.push_back(i);
+        }
+    }
+
+    ASSERT(gaps.size() == strays.size());
+
+    int const num_moves = int(gaps.size());
+
+    for_each_stripe([&v, &gaps, &strays, num_moves, num_stripes](int const s) {
+        for(int m = num_moves * s / num_stripes; m < num_moves * (s + 1) / num_stripes; ++m) {
+            for(int k = 0; k < block; ++k) {
+                assign(v, gaps[std::size_t(m)] + k, v[strays[std::size_t(m)] + k].get());
+            }
+        }
+    });
+
+    std::vector<bucket_pointers> pointers(static_cast<std::size_t>(num_buckets));
+
+    for(int b = 0; b < num_buckets; ++b) {
+        auto& p = pointers[std::size_t(b)];
+        p.write = region_begin[std::size_t(b)];
+        p.read = std::clamp(full_end, region_begin[std::size_t(b)], region_begin[std::size_t(b) + 1]);
+    }
+
+    // Takes the last block of `bucket` that is still to be placed, false once there is none. The block is copied
+    // under the lock, a thread claiming the slot right after may write to it.
+    auto take_block = [&v, &pointers](int const bucket, std::vector<key>& out) -> bool {
+        auto& p = pointers[std::size_t(bucket)];
+        std::lock_guard<std::mutex> guard{ p.lock };
+
+        if(p.read <= p.write) {
+            return false;
+        }
+
+        p.read -= block;
+
+        for(int k = 0; k < block; ++k) {
+            out[std::size_t(k)] = v[p.read + k].get();
+        }
+
+        return true;
+    };
+
+    // Claims the next slot of `bucket` and tells whether it still holds a block to be placed. No other thread can
+    // take that block anymore.
+    auto claim_slot = [&pointers, &region_begin](int const bucket) -> std::pair<int, bool> {
+        auto& p = pointers[std::size_t(bucket)];
+        std::lock_guard<std::mutex> guard{ p.lock };
+        int const slot = std::exchange(p.write, p.write + block);
+
+        ASSERT(slot + block <= region_begin[std::size_t(bucket) + 1]);
+        return { slot, slot < p.read };
+    };
+
+    for_each_stripe([&v, &classifier, &take_block, &claim_slot, num_buckets, num_stripes](int const s) {
+        std::vector<key> carried(static_cast<std::size_t>(block));
+        std::vector<key> displaced(static_cast<std::size_t>(block));
+        int const first_primary = num_buckets * s / num_stripes;
+
+        for(int k = 0; k < num_buckets; ++k) {
+            int const primary = (first_primary + k) % num_buckets;
+
+            while(take_block(primary, carried)) {
+                int target = classifier.classify(carried[0]);
+
+                // the carried block either lands in an empty slot of its bucket or swaps places with the next block
+                // there that belongs elsewhere, which is carried on
+                for(;;) {
+                    auto const [slot, occupied] = claim_slot(target);
+
+                    if(!occupied) {
+                        for(int i = 0; i < block; ++i) {
+                            assign(v, slot + i, carried[std::size_t(i)]);
+                        }
+
+                        break;
+                    }
+
+                    int const occupant = classifier.classify(v[slot].get());
+
+                    if(occupant == target) {
+                        continue;
+                    }
+
+                    for(int i = 0; i < block; ++i) {
+                        displaced[std::size_t(i)] = v[slot + i].get();
+                        assign(v, slot + i, carried[std::size_t(i)]);
+                    }
+
+                    std::swap(carried, displaced);
+                    target = occupant;
+                }
+            }
+        }
+    });
+
+    // A bucket's keys in front of where it begins are saved before the bucket ahead of it fills that space.
+    std::vector<key> heads(std::size_t(num_buckets * block));
+    std::vector<int> head_size(std::size_t(num_buckets), 0);
+
+    for_each_stripe([&](int const s) {
+        for(int b = num_buckets * s / num_stripes; b < num_buckets * (s + 1) / num_stripes; ++b) {
+            if(pointers[std::size_t(b)].write == region_begin[std::size_t(b)]) {
+                continue;
+            }
+
+            for(int i = region_begin[std::size_t(b)]; i < bucket_begin[std::size_t(b)]; ++i) {
+                heads[std::size_t(b * block + head_size[std::size_t(b)]++)] = v[i].get();
+            }
+        }
+    });
+
+    for_each_stripe([&](int const s) {
+        for(int b = num_buckets * s / num_stripes; b < num_buckets * (s + 1) / num_stripes; ++b) {
+            int dest = std::max(pointers[std::size_t(b)].write, bucket_begin[std::size_t(b)]);
+
+            for(int k = 0; k < head_size[std::size_t(b)]; ++k) {
+                assign(v, dest++, heads[std::size_t(b * block + k)]);
+            }
+
+            for(auto const& other : stripes) {
+                for(int k = 0; k < other.fill[std::size_t(b)]; ++k) {
+                    assign(v, dest++, other.buffers[std::size_t(b * block + k)]);
+                }
+            }
+
+            ASSERT(dest == bucket_begin[std::size_t(b) + 1]);
+        }
+    });
+
+    return bucket_begin;
+}
+
+template<typename Array>
+auto samplesort_impl(Array& v, int const begin, int const end) -> void
+{
+    if(end - begin <= g_sample_base_case) {
+        pdqsort_range(v, begin, end);
+        return;
+    }
+
+    auto const classifier = sample_splitters(v, begin, end);
+    auto const bucket_begin = sample_distribute(v, begin, end, classifier);
+    task_group group{ task_pool::instance() };
+
+    for(int b = 0; b < classifier.num_buckets(); ++b) {
+        int const first = bucket_begin[std::size_t(b)];
+        int const last = bucket_begin[std::size_t(b) + 1];
+
+        if(classifier.is_equality_bucket(b) || last - first < 2) {
+            continue;
+        }
+
+        if(last - first > g_parallel_cutoff) {
+            fork<Array>(group, [&v, first, last] { samplesort_impl(v, first, last); });
+        }
+        else {
+            samplesort_impl(v, first, last);
+        }
+    }
+
+    group.wait();
+}
+
+// In-place parallel super scalar samplesort after IPS4o: a sample picks up to 255 splitters, every key is
+// classified against them without branching and the range is distributed into the buckets block by block, in
+// place. Then the buckets are sorted the same way, in parallel.
+template<typename Array>
+auto samplesort(Array& data) -> void
+{
+    samplesort_impl(data, 0, data.isize());
+    data.end();
+}
+
+// Keys the scatter buffers per bucket before writing them out, a cache line's worth.
+template<typename Key>
+constexpr element_t g_scatter_buffer_size = 64 / sizeof(Key);
+
+// Moves the keys of [begin, end) to their bucket's slots in `to`, starting at `offsets`. Keys are gathered in small
+// per-bucket buffers first, so every write to `to` fills a whole cache line instead of touching 256 lines in turn.
+template<typename Array>
+auto radix_scatter(Array const& from,
+                   Array& to,
+                   element_t const byte,
+                   radix_histogram& offsets,
+                   element_t const begin,
+                   element_t const end) -> void
+{
+    constexpr element_t buffer_size = g_scatter_buffer_size<key_t<Array>>;
+
+    std::array<std::array<key_t<Array>, buffer_size>, g_radix_buckets> buffers{};
+    radix_histogram buffered{};
+
+    auto write_out = [&](element_t const bucket) {
+        for(element_t k = 0; k < buffered[bucket]; ++k) {
+            auto const index = offsets[bucket]++;
+            auto const value = buffers[bucket][k];
+            to[index] = value;
+            from.modify(index, value);
+        }
+
+        buffered[bucket] = 0;
+    };
+
+    for(element_t i = begin; i < end; ++i) {
+        auto const value = from[i].get();
+        auto const bucket = nth_byte(radix_key(value), byte);
+        buffers[bucket][buffered[bucket]++] = value;
+
+        if(buffered[bucket] == buffer_size) {
+            write_out(bucket);
+        }
+    }
+
+    for(element_t bucket = 0; bucket < g_radix_buckets; ++bucket) {
+        write_out(bucket);
+    }
+}
+
+// LSD radix sort, a byte per pass. The array is split in a chunk per thread: every pass counts each chunk's keys
+// in a histogram of its own, a prefix sum over (bucket, chunk) gives every chunk the slots it scatters its keys to,
+// then all chunks scatter at once.
+template<typename Array>
+auto parallel_radix_sort(Array& data) -> void
+{
+    auto& pool = task_pool::instance();
+    element_t const size = data.size();
+    element_t const num_chunks = std::clamp<element_t>(size / element_t{ g_parallel_cutoff }, 1, pool.concurrency());
+    element_t const chunk_size = (size + num_chunks - 1) / num_chunks;
+
+    Array tmp{ data }; // NOLINT
+    Array* from = &data;
+    Array* to = &tmp;
+    std::vector<radix_histogram> histograms(num_chunks);
+    task_group group{ pool };
+
+    auto for_each_chunk = [&](auto const& body) {
+        for(element_t c = 0; c < num_chunks; ++c) {
+            fork<Array>(group, [&body, c, begin = c * chunk_size, end = std::min(size, (c + 1) * chunk_size)] {
+                body(c, begin, end);
+            });
+        }
+
+        group.wait();
+    };
+
+    for(element_t byte = 0; byte < sizeof(radix_bits_t<key_t<Array>>); ++byte) {
+        for_each_chunk([from, byte, &histograms](element_t const c, element_t const begin, element_t const end) {
+            auto& histogram = histograms[c];
+            histogram.fill(0);
+
+            if constexpr(g_kernel_keys<Array>) {
+                byte_histogram(from->data() + begin, end - begin, byte, histogram);
+            }
+            else {
+                for(element_t i = begin; i < end; ++i) {
+                    ++histogram[nth_byte(radix_key((*from)[i].get()), byte)];
+                }
+            }
+        });
+
+        // every key has the same byte here, the pass wouldn't change the order
+        bool skip = false;
+
+        for(element_t bucket = 0; bucket < g_radix_buckets && !skip; ++bucket) {
+            element_t total = 0;
+
+            for(auto const& histogram : histograms) {
+                total += histogram[bucket];
+            }
+
+            skip = (total == size);
+        }
+
+        if(skip) {
+            continue;
+        }
+
+        element_t offset = 0;
+
+        for(element_t bucket = 0; bucket < g_radix_buckets; ++bucket) {
+            for(auto& histogram : histograms) {
+                offset += std::exchange(histogram[bucket], offset);
+            }
+        }
+
+        for_each_chunk([from, to, byte, &histograms](element_t const c, element_t const begin, element_t const end) {
+            radix_scatter(*from, *to, byte, histograms[c], begin, end);
+        });
+
+        std::swap(from, to);
+    }
+
+    if(from != &data) {
+        for_each_chunk([&data, &tmp](element_t, element_t const begin, element_t const end) {
+            for(element_t i = begin; i < end; ++i) {
+                auto const value = tmp[i].get();
+                data[i] = value;
+                data.modify(i, value);
+            }
+        });
+    }
+
+    data.end();
+}
+
+// Buckets this small are sorted by a sorting network.
+constexpr int g_flag_network_threshold = int(max_network_size);
+
+// Sorts [begin, end), whose keys agree on every byte above `byte`, in place: every element is swapped straight into
+// its bucket for this byte, and the one it displaces is placed next. Then the buckets are sorted by the next byte.
+template<typename Array>
+auto american_flag_sort_impl(Array& v, int const begin, int const end, element_t const byte) -> void
+{
+    if(end - begin <= g_flag_network_threshold) {
+        network_sort_range(v, begin, end);
+        return;
+    }
+
+    radix_histogram counts{};
+
+    if constexpr(g_kernel_keys<Array>) {
+        byte_histogram(v.data() + begin, element_t(end - begin), byte, counts);
+    }
+    else {
+        for(int i = begin; i < end; ++i) {
+            ++counts[nth_byte(radix_key(v[i].get()), byte)];
+        }
+    }
+
+    // bucket b ends up as [heads[b], tails[b]), heads[b] moves up as elements get there
+    radix_histogram heads{};
+    radix_histogram tails{};
+    auto offset = element_t(begin);
+
+    for(element_t bucket = 0; bucket < g_radix_buckets; ++bucket) {
+        heads[bucket] = offset;
+        offset += counts[bucket];
+        tails[bucket] = offset;
+    }
+
+    for(element_t bucket = 0; bucket < g_radix_buckets; ++bucket) {
+        while(heads[bucket] < tails[bucket]) {
+            auto const digit = nth_byte(radix_key(v[heads[bucket]].get()), byte);
+
+            if(digit == bucket) {
+                ++heads[bucket];
+            }
+            else {
+                v.swap_at(heads[bucket], heads[digit]++);
+            }
+        }
+    }
+
+    if(byte == 0) {
+        return;
+    }
+
+    auto bucket_begin = element_t(begin);
+
+    for(auto const bucket_end : tails) {
+        if(bucket_end - bucket_begin > 1) {
+            american_flag_sort_impl(v, int(bucket_begin), int(bucket_end), byte - 1);
+        }
+
+        bucket_begin = bucket_end;
+    }
+}
+
+// In-place MSD radix sort, it only needs a few histograms per level of recursion besides the array.
+template<typename Array>
+auto american_flag_sort(Array& data) -> void
+{
+    radix_bits_t<key_t<Array>> max = 0;
+
+    for(element_t i = 0; i < data.size(); ++i) {
+        max = std::max(max, radix_key(data[i].get()));
+    }
+
+    // bytes above the highest one set in the largest key are zero everywhere
+    american_flag_sort_impl(data, 0, data.isize(), highest_byte(max));
+    data.end();
+}
+
+// Counting only pays off while the counters take no more room than the array does, or fit in L2 anyway.
+constexpr element_t g_count_sort_cached_counters = element_t{ 1 } << 15U;
+
+// Counts every key between the smallest and the largest one, by their radix bits. Keys spread too far apart for
+// that are sorted by their bytes instead, starting at the highest one that isn't the same in all of them.
+template<typename Array>
+auto count_sort(Array& data) -> void
+{
+    // the keys are rebuilt from their counts, anything riding along with them would get lost
+    static_assert(std::is_arithmetic_v<key_t<Array>>, "count_sort only sorts plain numbers");
+
+    using bits_t = radix_bits_t<key_t<Array>>;
+
+    if(data.size() == 0) {
+        return data.end();
+    }
+
+    bits_t min = 0;
+    bits_t max = 0;
+
+    if constexpr(g_kernel_keys<Array>) {
+        std::tie(min, max) = key_range(data.data(), data.size());
+    }
+    else {
+        min = max = radix_key(data[0].get());
+
+        for(int i = 1; i < data.isize(); ++i) {
+            auto const key = radix_key(data[i].get());
+            min = std::min(min, key);
+            max = std::max(max, key);
+        }
+    }
+
+    if(max - min >= std::max(2 * data.size(), g_count_sort_cached_counters)) {
+        american_flag_sort_impl(data, 0, data.isize(), highest_byte(bits_t(min ^ max)));
+        return data.end();
+    }
+
+    std::vector<core::element_t> frecv(std::size_t(max - min) + 1, 0U);
+
+    if constexpr(g_kernel_keys<Array>) {
+        value_histogram(data.data(), data.size(), min, frecv.data());
+    }
+    else {
+        for(int i = 0; i < data.isize(); ++i) {
+            ++frecv[radix_key(data[i].get()) - min];
+        }
+    }
+
+    core::element_t index{ 0 };
+    for(core::element_t i = 0; i < frecv.size(); ++i) {
+        auto const key = key_traits<key_t<Array>>::from_bits(bits_t(min + i));
+
+        for(core::element_t j = 0; j < frecv[i]; ++j) {
+            data[index] = key;
+            data.modify(index, key);
+            ++index;
+        }
+    }
+
+    data.end();
+}
+
+// Sorts the leaves of the merge sorts without reordering equal keys. Equal numbers can't be told apart, so those
+// still go through the sorting networks.
+template<typename Array>
+auto stable_leaf_sort(Array& v, int const begin, int const end) -> void
+{
+    if constexpr(std::is_arithmetic_v<key_t<Array>>) {
+        network_sort_range(v, begin, end);
+    }
+    else {
+        pdq_insertion_sort<true>(v, begin, end);
+    }
+}
+
+template<typename Array>
+auto merge(Array& v, int const left, int const mid, int const right) -> void
+{
+    std::vector<key_t<Array>> tmp;
+    tmp.reserve(std::size_t(right - left) + 1);
+
+    int i = left;
+    int j = mid + 1;
+
+    while(i <= mid && j <= right) {
+        if(!(v[j] < v[i])) {
+            tmp.push_back(v[i++].get());
+        }
+        else {
+            tmp.push_back(v[j++].get());
+        }
+    }
+
+    while(i <= mid) {
+        tmp.push_back(v[i++].get());
+    }
+    while(j <= right) {
+        tmp.push_back(v[j++].get());
+    }
+
+    for(i = left; i <= right; ++i) {
+        v[i] = tmp[std::size_t(i - left)];
+        v.modify(core::element_t(i), tmp[std::size_t(i - left)]);
+    }
+}
+
+template<typename Array>
+auto merge_sort_impl(Array& v, int const left, int const right) -> void
+{
+    if(right - left < g_network_leaf_size) {
+        stable_leaf_sort(v, left, right + 1);
+    }
+    else {
+        int const mid = left + (right - left) / 2;
+        merge_sort_impl(v, left, mid);
+        merge_sort_impl(v, mid + 1, right);
+        merge(v, left, mid, right);
+    }
+}
+
+template<typename Array>
+auto merge_sort(Array& data) -> void
+{
+    merge_sort_impl(data, 0, data.isize() - 1);
+    data.end();
+}
+
+// Blocks the bottom-up merge sort starts from, they fit in a few cache lines and are sorted by a sorting network.
+constexpr int g_merge_block_size = int(max_network_size);
+
+// Merges the sorted runs [left, mid) and [mid, right) of `from` into the same positions of `to`.
+template<typename Array>
+auto merge_into(Array const& from, Array& to, int const left, int const mid, int const right) -> void
+{
+    int i = left;
+    int j = mid;
+    int k = left;
+
+    // runs that are already in order are only copied
+    if(j == right || !(from[j] < from[j - 1])) {
+        for(; k < right; ++k) {
+            assign(to, k, from[k].get());
+        }
+
+        return;
+    }
+
+    while(i < mid && j < right) {
+        if(from[j] < from[i]) {
+            assign(to, k++, from[j++].get());
+        }
+        else {
+            assign(to, k++, from[i++].get());
+        }
+    }
+
+    while(i < mid) {
+        assign(to, k++, from[i++].get());
+    }
+    while(j < right) {
+        assign(to, k++, from[j++].get());
+    }
+}
+
+// Iterative merge sort: blocks are sorted by a sorting network, then runs of doubling width are merged back and
+// forth between the array and a single buffer allocated up front.
+template<typename Array>
+auto merge_sort_bottom_up(Array& data) -> void
+{
+    int const size = data.isize();
+
+    for(int begin = 0; begin < size; begin += g_merge_block_size) {
+        stable_leaf_sort(data, begin, std::min(size, begin + g_merge_block_size));
+    }
+
+    if(size > g_merge_block_size) {
+        Array buffer{ data }; // NOLINT
+        Array* from = &data;
+        Array* to = &buffer;
+
+        for(int width = g_merge_block_size; width < size; width *= 2) {
+            for(int left = 0; left < size; left += 2 * width) {
+                int const mid = std::min(size, left + width);
+                merge_into(*from, *to, left, mid, std::min(size, left + 2 * width));
+            }
+
+            std::swap(from, to);
+        }
+
+        if(from != &data) {
+            for(int i = 0; i < size; ++i) {
+                assign(data, i, buffer[i].get());
+            }
+        }
+    }
+
+    data.end();
+}
+
+// Runs the multiway merge sort merges in one pass, unless fewer are left.
+constexpr int g_multiway_min_fan_in = 8;
+constexpr int g_multiway_max_fan_in = 64;
+
+// The fewest runs per pass, at least `g_multiway_min_fan_in`, that merge `runs` runs in as few passes as
+// `g_multiway_max_fan_in` would.
+[[nodiscard]] inline auto multiway_fan_in(int const runs) -> int
+{
+    auto const reach = [runs](int const fan_in, int const passes) {
+        std::int64_t merged = 1;
+
+        for(int pass = 0; pass < passes && merged < runs; ++pass) {
+            merged *= fan_in;
+        }
+
+        return merged;
+    };
+
+    int passes = 0;
+
+    while(reach(g_multiway_max_fan_in, passes) < runs) {
+        ++passes;
+    }
+
+    int fan_in = g_multiway_min_fan_in;
+
+    while(reach(fan_in, passes) < runs) {
+        ++fan_in;
+    }
+
+    return fan_in;
+}
+
+// Orders positions of `**from` by their keys. The comparison goes through the array, so the merge shows up in the
+// events and statistics like every other one, and the tree follows `from` between passes.
+template<typename Array>
+struct position_less
+{
+    Array* const* from{ nullptr };
+
+    [[nodiscard]] auto operator()(int const a, int const b) const -> bool
+    {
+        return (**from)[a] < (**from)[b];
+    }
+};
+
+template<typename Array>
+using position_tree = loser_tree<int, position_less<Array>>;
+
+// Merges the sorted runs of `width` elements that [left, right) of `from` is made of into the same positions of
+// `to`. `tree` compares positions of `from`.
+template<typename Array>
+auto multiway_merge_into(Array const& from,
+                         Array& to,
+                         int const left,
+                         int const width,
+                         int const right,
+                         position_tree<Array>& tree) -> void
+{
+    int const sources = (right - left + width - 1) / width;
+
+    if(sources == 1) {
+        for(int k = left; k < right; ++k) {
+            assign(to, k, from[k].get());
+        }
+
+        return;
+    }
+
+    tree.clear();
+
+    for(int s = 0; s < sources; ++s) {
+        tree.set(static_cast<std::size_t>(s), left + s * width);
+    }
+
+    tree.build();
+
+    for(int k = left; k < right; ++k) {
+        int const next = tree.top() + 1;
+        int const end = std::min(right, left + (static_cast<int>(tree.top_source()) + 1) * width);
+
+        assign(to, k, from[tree.top()].get());
+
+        if(next < end) {
+            tree.replace_top(next);
+        }
+        else {
+            tree.pop_top();
+        }
+    }
+}
+
+// Bottom-up merge sort that merges up to 64 runs at once with a loser tree, so the array goes through memory
+// log_k(n / 32) times instead of log2(n / 32). Equal keys keep their order.
+template<typename Array>
+auto multiway_merge_sort(Array& data) -> void
+{
+    int const size = data.isize();
+
+    for(int begin = 0; begin < size; begin += g_merge_block_size) {
+        stable_leaf_sort(data, begin, std::min(size, begin + g_merge_block_size));
+    }
+
+    if(size > g_merge_block_size) {
+        int const fan_in = multiway_fan_in((size + g_merge_block_size - 1) / g_merge_block_size);
+        Array buffer{ data }; // NOLINT
+        Array* from = &data;
+        Array* to = &buffer;
+        position_tree<Array> tree{ static_cast<std::size_t>(fan_in), position_less<Array>{ &from } };
+
+        for(std::int64_t width = g_merge_block_size; width < size; width *= fan_in) {
+            auto const span = width * fan_in;
+
+            for(std::int64_t left = 0; left < size; left += span) {
+                multiway_merge_into(*from,
+                                    *to,
+                                    static_cast<int>(left),
+                                    static_cast<int>(width),
+                                    static_cast<int>(std::min<std::int64_t>(size, left + span)),
+                                    tree);
+            }
+
+            std::swap(from, to);
+        }
+
+        if(from != &data) {
+            for(int i = 0; i < size; ++i) {
+                assign(data, i, buffer[i].get());
+            }
+        }
+    }
+
+    data.end();
+}
+
+// Arrays shorter than this are binary insertion sorted as a single run.
+constexpr int g_tim_min_merge = 32;
+// Consecutive wins of one run before a merge switches to galloping.
+constexpr int g_tim_min_gallop = 7;
+
+// Position of the first element of [base, base + len) that is not less than `key`, searched from `base + hint`
+// outwards with growing steps, then by bisection. `at` reads an element.
+template<typename Key, typename At>
+auto gallop_left(Key const& key, At const& at, int const base, int const len, int const hint) -> int
+{
+    int last_offset = 0;
+    int offset = 1;
+
+    if(at(base + hint) < key) {
+        int const max_offset = len - hint;
+
+        while(offset < max_offset && at(base + hint + offset) < key) {
+            last_offset = offset;
+            offset = std::min(2 * offset + 1, max_offset);
+        }
+
+        offset = std::min(offset, max_offset);
+        last_offset += hint;
+        offset += hint;
+    }
+    else {
+        int const max_offset = hint + 1;
+
+        while(offset < max_offset && !(at(base + hint - offset) < key)) {
+            last_offset = offset;
+            offset = std::min(2 * offset + 1, max_offset);
+        }
+
+        offset = std::min(offset, max_offset);
+        std::tie(last_offset, offset) = std::pair{ hint - offset, hint - last_offset };
+    }
+
+    ++last_offset;
+
+    while(last_offset < offset) {
+        int const mid = last_offset + (offset - last_offset) / 2;
+
+        if(at(base + mid) < key) {
+            last_offset = mid + 1;
+        }
+        else {
+            offset = mid;
+        }
+    }
+
+    return offset;
+}
+
+// Like `gallop_left`, but finds the first element greater than `key`.
+template<typename Key, typename At>
+auto gallop_right(Key const& key, At const& at, int const base, int const len, int const hint) -> int
+{
+    int last_offset = 0;
+    int offset = 1;
+
+    if(key < at(base + hint)) {
+        int const max_offset = hint + 1;
+
+        while(offset < max_offset && key < at(base + hint - offset)) {
+            last_offset = offset;
+            offset = std::min(2 * offset + 1, max_offset);
+        }
+
+        offset = std::min(offset, max_offset);
+        std::tie(last_offset, offset) = std::pair{ hint - offset, hint - last_offset };
+    }
+    else {
+        int const max_offset = len - hint;
+
+        while(offset < max_offset && !(key < at(base + hint + offset))) {
+            last_offset = offset;
+            offset = std::min(2 * offset + 1, max_offset);
+        }
+
+        offset = std::min(offset, max_offset);
+        last_offset += hint;
+        offset += hint;
+    }
+
+    ++last_offset;
+
+    while(last_offset < offset) {
+        int const mid = last_offset + (offset - last_offset) / 2;
+
+        if(key < at(base + mid)) {
+            offset = mid;
+        }
+        else {
+            last_offset = mid + 1;
+        }
+    }
+
+    return offset;
+}
+
+// Natural merge sort: existing runs are found and extended to a minimum length by binary insertion, then merged
+// while keeping the lengths on the run stack balanced. A merge that sees one run win often gallops through it.
+template<typename Array>
+class timsort_state
+{
+private:
+    struct run
+    {
+        int base;
+        int length;
+    };
+
+    Array& m_data;
+    // holds the shorter run of a merge, sized once for the largest one
+    std::vector<key_t<Array>> m_buffer{};
+    std::vector<run> m_runs{};
+    int m_min_gallop{ g_tim_min_gallop };
+
+    [[nodiscard]] auto value(int const i) -> key_t<Array>
+    {
+        return m_data[i].get();
+    }
+
+    [[nodiscard]] static auto min_run_length(int size) noexcept -> int
+    {
+        int extra = 0;
+
+        while(size >= g_tim_min_merge) {
+            extra |= size & 1;
+            size >>= 1;
+        }
+
+        return size + extra;
+    }
+
+    // Length of the run starting at `begin`, a strictly descending one is reversed first.
+    auto count_run(int const begin, int const end) -> int
+    {
+        int run_end = begin + 1;
+
+        if(run_end == end) {
+            return 1;
+        }
+
+        if(m_data[run_end] < m_data[begin]) {
+            ++run_end;
+
+            while(run_end < end && m_data[run_end] < m_data[run_end - 1]) {
+                ++run_end;
+            }
+
+            for(int lo = begin, hi = run_end - 1; lo < hi; ++lo, --hi) {
+                m_data.swap_at(lo, hi);
+            }
+        }
+        else {
+            ++run_end;
+
+            while(run_end < end && !(m_data[run_end] < m_data[run_end - 1])) {
+                ++run_end;
+            }
+        }
+
+        return run_end - begin;
+    }
+
+    // Sorts [begin, end) of which [begin, start) is already sorted.
+    auto binary_insertion_sort(int const begin, int const end, int const start) -> void
+    {
+        for(int i = start; i < end; ++i) {
+            auto const key = this->value(i);
+            int lo = begin;
+            int hi = i;
+
+            while(lo < hi) {
+                int const mid = lo + (hi - lo) / 2;
+
+                if(key < this->value(mid)) {
+                    hi = mid;
+                }
+                else {
+                    lo = mid + 1;
+                }
+            }
+
+            for(int k = i; k > lo; --k) {
+                assign(m_data, k, this->value(k - 1));
+            }
+
+            assign(m_data, lo, key);
+        }
+    }
+
+    // Merges two adjacent runs, the first one being the shorter. It goes to the buffer and the merge fills the
+    // array from the front.
+    auto merge_low(int const base1, int len1, int const base2, int len2) -> void
+    {
+        auto const at_data = [this](int const i) { return this->value(i); };
+        auto const at_buffer = [this](int const i) { return m_buffer[std::size_t(i)]; };
+
+        m_buffer.clear();
+
+        for(int k = 0; k < len1; ++k) {
+            m_buffer.push_back(this->value(base1 + k));
+        }
+
+        int cursor1 = 0;
+        int cursor2 = base2;
+        int dest = base1;
+        int min_gallop = m_min_gallop;
+
+        assign(m_data, dest++, this->value(cursor2++));
+
+        // returns once the second run is used up or one element of the first is left
+        [&] {
+            if(--len2 == 0 || len1 == 1) {
+                return;
+            }
+
+            for(;;) {
+                int wins1 = 0;
+                int wins2 = 0;
+
+                do {
+                    if(this->value(cursor2) < m_buffer[std::size_t(cursor1)]) {
+                        assign(m_data, dest++, this->value(cursor2++));
+                        ++wins2;
+                        wins1 = 0;
+
+                        if(--len2 == 0) {
+                            return;
+                        }
+                    }
+                    else {
+                        assign(m_data, dest++, m_buffer[std::size_t(cursor1++)]);
+                        ++wins1;
+                        wins2 = 0;
+
+                        if(--len1 == 1) {
+                            return;
+                        }
+                    }
+                } while((wins1 | wins2) < min_gallop);
+
+                // one run keeps winning, find out how far at once
+                do {
+                    wins1 = gallop_right(this->value(cursor2), at_buffer, cursor1, len1, 0);
+
+                    for(int k = 0; k < wins1; ++k) {
+                        assign(m_data, dest++, m_buffer[std::size_t(cursor1++)]);
+                    }
+
+                    if((len1 -= wins1) <= 1) {
+                        return;
+                    }
+
+                    assign(m_data, dest++, this->value(cursor2++));
+
+                    if(--len2 == 0) {
+                        return;
+                    }
+
+                    wins2 = gallop_left(m_buffer[std::size_t(cursor1)], at_data, cursor2, len2, 0);
+
+                    for(int k = 0; k < wins2; ++k) {
+                        assign(m_data, dest++, this->value(cursor2++));
+                    }
+
+                    if((len2 -= wins2) == 0) {
+                        return;
+                    }
+
+                    assign(m_data, dest++, m_buffer[std::size_t(cursor1++)]);
+
+                    if(--len1 == 1) {
+                        return;
+                    }
+
+                    --min_gallop;
+                } while(wins1 >= g_tim_min_gallop || wins2 >= g_tim_min_gallop);
+
+                // leaving galloping mode makes entering it again harder
+                min_gallop = std::max(min_gallop, 0) + 2;
+            }
+        }();
+
+        m_min_gallop = std::max(min_gallop, 1);
+
+        if(len1 == 1) {
+            for(int k = 0; k < len2; ++k) {
+                assign(m_data, dest++, this->value(cursor2++));
+            }
+
+            assign(m_data, dest, m_buffer[std::size_t(cursor1)]);
+            return;
+        }
+
+        for(int k = 0; k < len1; ++k) {
+            assign(m_data, dest++, m_buffer[std::size_t(cursor1++)]);
+        }
+    }
+
+    // Mirror image of `merge_low` for a shorter second run: it goes to the buffer and the merge fills the array from
+    // the back.
+    auto merge_high(int const base1, int len1, int const base2, int len2) -> void
+    {
+        auto const at_data = [this](int const i) { return this->value(i); };
+        auto const at_buffer = [this](int const i) { return m_buffer[std::size_t(i)]; };
+
+        m_buffer.clear();
+
+        for(int k = 0; k < len2; ++k) {
+            m_buffer.push_back(this->value(base2 + k));
+        }
+
+        int cursor1 = base1 + len1 - 1;
+        int cursor2 = len2 - 1;
+        int dest = base2 + len2 - 1;
+        int min_gallop = m_min_gallop;
+
+        assign(m_data, dest--, this->value(cursor1--));
+
+        // returns once the first run is used up or one element of the second is left
+        [&] {
+            if(--len1 == 0 || len2 == 1) {
+                return;
+            }
+
+            for(;;) {
+                int wins1 = 0;
+                int wins2 = 0;
+
+                do {
+                    if(m_buffer[std::size_t(cursor2)] < this->value(cursor1)) {
+                        assign(m_data, dest--, this->value(cursor1--));
+                        ++wins1;
+                        wins2 = 0;
+
+                        if(--len1 == 0) {
+                            return;
+                        }
+                    }
+                    else {
+                        assign(m_data, dest--, m_buffer[std::size_t(cursor2--)]);
+                        ++wins2;
+                        wins1 = 0;
+
+                        if(--len2 == 1) {
+                            return;
+                        }
+                    }
+                } while((wins1 | wins2) < min_gallop);
+
+                do {
+                    wins1 = len1 - gallop_right(m_buffer[std::size_t(cursor2)], at_data, base1, len1, len1 - 1);
+
+                    for(int k = 0; k < wins1; ++k) {
+                        assign(m_data, dest--, this->value(cursor1--));
+                    }
+
+                    if((len1 -= wins1) == 0) {
+                        return;
+                    }
+
+                    assign(m_data, dest--, m_buffer[std::size_t(cursor2--)]);
+
+                    if(--len2 == 1) {
+                        return;
+                    }
+
+                    wins2 = len2 - gallop_left(this->value(cursor1), at_buffer, 0, len2, len2 - 1);
+
+                    for(int k = 0; k < wins2; ++k) {
+                        assign(m_data, dest--, m_buffer[std::size_t(cursor2--)]);
+                    }
+
+                    if((len2 -= wins2) <= 1) {
+                        return;
+                    }
+
+                    assign(m_data, dest--, this->value(cursor1--));
+
+                    if(--len1 == 0) {
+                        return;
+                    }
+
+                    --min_gallop;
+                } while(wins1 >= g_tim_min_gallop || wins2 >= g_tim_min_gallop);
+
+                min_gallop = std::max(min_gallop, 0) + 2;
+            }
+        }();
+
+        m_min_gallop = std::max(min_gallop, 1);
+
+        if(len2 == 1) {
+            for(int k = 0; k < len1; ++k) {
+                assign(m_data, dest--, this->value(cursor1--));
+            }
+
+            assign(m_data, dest, m_buffer[std::size_t(cursor2)]);
+            return;
+        }
+
+        for(int k = 0; k < len2; ++k) {
+            assign(m_data, dest--, m_buffer[std::size_t(cursor2--)]);
+        }
+    }
+
+    // Merges the runs `i` and `i + 1` of the stack.
+    auto merge_at(std::size_t const i) -> void
+    {
+        auto [base1, len1] = m_runs[i];
+        auto [base2, len2] = m_runs[i + 1];
+
+        m_runs[i].length = len1 + len2;
+        m_runs.erase(m_runs.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+
+        // elements of the first run that are no greater than the second's first and elements of the second that are
+        // no less than the first's last already are in place
+        auto const at = [this](int const k) { return this->value(k); };
+        int const skip = gallop_right(this->value(base2), at, base1, len1, 0);
+
+        base1 += skip;
+        len1 -= skip;
+
+        if(len1 == 0) {
+            return;
+        }
+
+        len2 = gallop_left(this->value(base1 + len1 - 1), at, base2, len2, len2 - 1);
+
+        if(len2 == 0) {
+            return;
+        }
+
+        if(len1 <= len2) {
+            this->merge_low(base1, len1, base2, len2);
+        }
+        else {
+            this->merge_high(base1, len1, base2, len2);
+        }
+    }
+
+    // Merges until every run is longer than the next one and the sum of the next two, so that the stack stays
+    // logarithmic in size and merged runs have similar lengths.
+    auto merge_collapse() -> void
+    {
+        auto const length = [this](std::size_t const k) { return m_runs[k].length; };
+
+        while(m_runs.size() > 1) {
+            auto n = m_runs.size() - 2;
+
+            if((n > 0 && length(n - 1) <= length(n) + length(n + 1)) ||
+               (n > 1 && length(n - 2) <= length(n - 1) + length(n))) {
+                if(length(n - 1) < length(n + 1)) {
+                    --n;
+                }
+            }
+            else if(length(n) > length(n + 1)) {
+                break;
+            }
+
+            this->merge_at(n);
+        }
+    }
+
+    auto force_collapse() -> void
+    {
+        while(m_runs.size() > 1) {
+            auto n = m_runs.size() - 2;
+
+            if(n > 0 && m_runs[n - 1].length < m_runs[n + 1].length) {
+                --n;
+            }
+
+            this->merge_at(n);
+        }
+    }
+
+public:
+    timsort_state() = delete;
+    timsort_state(timsort_state const&) = delete;
+    timsort_state(timsort_state&&) = delete;
+    ~timsort_state() noexcept = default;
+
+    explicit timsort_state(Array& data)
+        : m_data{ data }
+    {
+        m_buffer.reserve(data.size() / 2 + 1);
+    }
+
+    auto operator=(timsort_state const&) -> timsort_state& = delete;
+    auto operator=(timsort_state&&) -> timsort_state& = delete;
+
+    auto sort() -> void
+    {
+        int const size = m_data.isize();
+
+        if(size < 2) {
+            return;
+        }
+        if(size < g_tim_min_merge) {
+            this->binary_insertion_sort(0, size, this->count_run(0, size));
+            return;
+        }
+
+        int const min_run = min_run_length(size);
+
+        for(int begin = 0; begin < size;) {
+            int length = this->count_run(begin, size);
+
+            if(length < min_run) {
+                int const forced = std::min(min_run, size - begin);
+                this->binary_insertion_sort(begin, begin + forced, begin + length);
+                length = forced;
+            }
+
+            m_runs.push_back({ begin, length });
+            this->merge_collapse();
+            begin += length;
+        }
+
+        this->force_collapse();
+    }
+};
+
+template<typename Array>
+auto timsort(Array& data) -> void
+{
+    timsort_state<Array>{ data }.sort();
+    data.end();
+}
+
+// Merges the sorted runs [a_begin, a_end) and [b_begin, b_end) of `v`, the first one coming first, into `out` from
+// `dest` on. Large merges are split around the middle of the longer run, whose place in the other one is found by
+// binary search, and both halves are merged in parallel.
+template<typename Array>
+auto parallel_merge(Array& v,
+                    std::vector<key_t<Array>>& out,
+                    int a_begin,
+                    int const a_end,
+                    int b_begin,
+                    int const b_end,
+                    int dest,
+                    task_group& group) -> void
+{
+    while((a_end - a_begin) + (b_end - b_begin) > g_parallel_cutoff) {
+        bool const split_first = a_end - a_begin >= b_end - b_begin;
+        int a_mid = a_begin;
+        int b_mid = b_begin;
+
+        // elements of the second run equal to one of the first go after it, which keeps the merge stable
+        if(split_first) {
+            a_mid = a_begin + (a_end - a_begin) / 2;
+
+            for(int count = b_end - b_begin; count > 0;) {
+                int const step = count / 2;
+
+                if(v[b_mid + step] < v[a_mid]) {
+                    b_mid += step + 1;
+                    count -= step + 1;
+                }
+                else {
+                    count = step;
+                }
+            }
+        }
+        else {
+            b_mid = b_begin + (b_end - b_begin) / 2;
+
+            for(int count = a_end - a_begin; count > 0;) {
+                int const step = count / 2;
+
+                if(v[a_mid + step] <= v[b_mid]) {
+                    a_mid += step + 1;
+                    count -= step + 1;
+                }
+                else {
+                    count = step;
+                }
+            }
+        }
+
+        int const pivot = dest + (a_mid - a_begin) + (b_mid - b_begin);
+        out[std::size_t(pivot)] = split_first ? v[a_mid].get() : v[b_mid].get();
+
+        fork<Array>(group, [&v, &out, a_begin, a_mid, b_begin, b_mid, dest, &group] {
+            parallel_merge(v, out, a_begin, a_mid, b_begin, b_mid, dest, group);
+        });
+
+        dest = pivot + 1;
+        a_begin = split_first ? a_mid + 1 : a_mid;
+        b_begin = split_first ? b_mid : b_mid + 1;
+    }
+
+    int i = a_begin;
+    int j = b_begin;
+
+    while(i < a_end && j < b_end) {
+        if(v[j] < v[i]) {
+            out[std::size_t(dest++)] = v[j++].get();
+        }
+        else {
+            out[std::size_t(dest++)] = v[i++].get();
+        }
+    }
+
+    while(i < a_end) {
+        out[std::size_t(dest++)] = v[i++].get();
+    }
+    while(j < b_end) {
+        out[std::size_t(dest++)] = v[j++].get();
+    }
+}
+
+template<typename Array>
+auto parallel_merge_sort_impl(Array& v, std::vector<key_t<Array>>& buffer, int const left, int const right)
+    -> void
+{
+    if(right - left <= g_parallel_cutoff) {
+        merge_sort_impl(v, left, right - 1);
+        return;
+    }
+
+    int const mid = left + (right - left) / 2;
+    task_group group{ task_pool::instance() };
+
+    fork<Array>(group, [&v, &buffer, left, mid] { parallel_merge_sort_impl(v, buffer, left, mid); });
+    parallel_merge_sort_impl(v, buffer, mid, right);
+    group.wait();
+
+    parallel_merge(v, buffer, left, mid, mid, right, left, group);
+    group.wait();
+
+    for(int begin = left; begin < right; begin += g_parallel_cutoff) {
+        fork<Array>(group, [&v, &buffer, begin, end = std::min(right, begin + g_parallel_cutoff)] {
+            for(int i = begin; i < end; ++i) {
+                v[i] = buffer[std::size_t(i)];
+                v.modify(core::element_t(i), buffer[std::size_t(i)]);
+            }
+        });
+    }
+
+    group.wait();
+}
+
+template<typename Array>
+auto parallel_merge_sort(Array& data) -> void
+{
+    std::vector<key_t<Array>> buffer(data.size());
+
+    parallel_merge_sort_impl(data, buffer, 0, data.isize());
+    data.end();
+}
+
+template<typename Array>
+auto heap_sort(Array& data) -> void
+{
+    heap_sort_range(data, 0, data.isize());
+    data.end();
+}
+
+// With 16 byte values the four children of a node fill exactly one cache line, eight fill two.
+template<typename Array>
+auto heap_sort_4ary(Array& data) -> void
+{
+    heap_sort_range<4>(data, 0, data.isize());
+    data.end();
+}
+
+template<typename Array>
+auto heap_sort_8ary(Array& data) -> void
+{
+    heap_sort_range<8>(data, 0, data.isize());
+    data.end();
+}
+
+// Sifts the value at `root` of the binary max-heap [0, size) down Wegener's way: first follow the larger children
+// to a leaf, one comparison per level, then climb back up to where the value belongs and shift the path above it up
+// by one. The value sifted after a sort-down swap is small and belongs near the leaves, so the climb is short and
+// this does about half the comparisons of `sift_down`.
+template<typename Array>
+auto sift_down_bottom_up(Array& v, int const root, int const size) -> void
+{
+    int leaf = root;
+
+    while(2 * leaf + 2 < size) {
+        leaf = (v[2 * leaf + 1] < v[2 * leaf + 2]) ? 2 * leaf + 2 : 2 * leaf + 1;
+    }
+    if(2 * leaf + 1 < size) {
+        leaf = 2 * leaf + 1;
+    }
+
+    while(v[leaf] < v[root]) {
+        leaf = (leaf - 1) / 2;
+    }
+
+    auto carried = v[root].get();
+
+    while(leaf > root) {
+        auto const displaced = v[leaf].get();
+        assign(v, leaf, carried);
+        carried = displaced;
+        leaf = (leaf - 1) / 2;
+    }
+
+    assign(v, root, carried);
+}
+
+template<typename Array>
+auto heap_sort_bottom_up(Array& data) -> void
+{
+    int const size = data.isize();
+
+    for(int root = size / 2 - 1; root >= 0; --root) {
+        sift_down_bottom_up(data, root, size);
+    }
+    for(int last = size - 1; last > 0; --last) {
+        data.swap_at(0, last);
+        sift_down_bottom_up(data, 0, last);
+    }
+
+    data.end();
+}
+
+// Batcher's odd-even merge sort network over the whole array, one layer of comparators after the other. Does
+// O(n log^2 n) comparisons whatever the input, it's meant to be watched on small arrays.
+template<typename Array>
+auto sorting_network(Array& data) -> void
+{
+    for_each_comparator(data.size(), [&data](std::size_t const low, std::size_t const high, std::size_t) {
+        sort2(data, int(low), int(high));
+    });
+
+    data.end();
+}
+
+template<typename Array>
+auto insertion_sort(Array& data) -> void
+{
+    for(int i = 1; i < data.isize(); ++i) {
+        int j = i - 1;
+        while(j >= 0 && data[j] > data[j + 1]) {
+            data.swap_at(j, j + 1);
+            --j;
+        }
+    }
+
+    data.end();
+}
+
+#define SORTVIS_INSTANTIATE_FOR(algorithm, key)                                                                        \
+    template auto algorithm(core::silent_array_of<key>& data)->void
+
+#define SORTVIS_INSTANTIATE_NUMBERS(algorithm)                                                                         \
+    template auto algorithm(core::basic_array<core::normal_emitter>& data)->void;                                      \
+    template auto algorithm(core::basic_array<core::null_emitter>& data)->void;                                        \
+    template auto algorithm(core::basic_array<core::stats_emitter>& data)->void;                                       \
+    SORTVIS_INSTANTIATE_FOR(algorithm, std::uint32_t);                                                                 \
+    SORTVIS_INSTANTIATE_FOR(algorithm, std::int32_t);                                                                  \
+    SORTVIS_INSTANTIATE_FOR(algorithm, std::int64_t);                                                                  \
+    SORTVIS_INSTANTIATE_FOR(algorithm, float);                                                                         \
+    SORTVIS_INSTANTIATE_FOR(algorithm, double)
+
+#define SORTVIS_INSTANTIATE(algorithm)                                                                                 \
+    SORTVIS_INSTANTIATE_NUMBERS(algorithm);                                                                            \
+    SORTVIS_INSTANTIATE_FOR(algorithm, core::key_value)
+
+SORTVIS_INSTANTIATE_NUMBERS(count_sort);
+SORTVIS_INSTANTIATE(bubble_sort);
+SORTVIS_INSTANTIATE(radix_sort);
+SORTVIS_INSTANTIATE(radix_sort_simple);
+SORTVIS_INSTANTIATE(parallel_radix_sort);
+SORTVIS_INSTANTIATE(american_flag_sort);
+SORTVIS_INSTANTIATE(quicksort);
+SORTVIS_INSTANTIATE(parallel_quicksort);
+SORTVIS_INSTANTIATE(samplesort);
+SORTVIS_INSTANTIATE(pdqsort);
+SORTVIS_INSTANTIATE(merge_sort);
+SORTVIS_INSTANTIATE(merge_sort_bottom_up);
+SORTVIS_INSTANTIATE(multiway_merge_sort);
+SORTVIS_INSTANTIATE(timsort);
+SORTVIS_INSTANTIATE(parallel_merge_sort);
+SORTVIS_INSTANTIATE(heap_sort);
+SORTVIS_INSTANTIATE(heap_sort_4ary);
+SORTVIS_INSTANTIATE(heap_sort_8ary);
+SORTVIS_INSTANTIATE(heap_sort_bottom_up);
+SORTVIS_INSTANTIATE(sorting_network);
+SORTVIS_INSTANTIATE(insertion_sort);
+
+#undef SORTVIS_INSTANTIATE
+#undef SORTVIS_INSTANTIATE_NUMBERS
+#undef SORTVIS_INSTANTIATE_FOR
+
 } // namespace core::algorithm
@@ -4,19 +4,60 @@
 
 namespace core {
 
-class array;
+template<typename Emitter, typename Key>
+class basic_array;
 
 }
 
+// Every algorithm is explicitly instantiated in algorithm.cpp for arrays using `core::normal_emitter`
+// (visualized), `core::null_emitter` (no events at all, for timing) and `core::stats_emitter` (operation counts).
+// Silent arrays are also covered for `std::uint32_t`, `std::int32_t`, `std::int64_t`, `float`, `double` and
+// `core::key_value` keys, except that `count_sort` only takes numbers.
+// The parallel ones run on `core::task_pool::instance()`.
 namespace core::algorithm {
 
-auto count_sort(core::array& data) -> void;
-auto bubble_sort(core::array& data) -> void;
-auto radix_sort(core::array& data) -> void;
-auto radix_sort_simple(core::array& data) -> void;
-auto quicksort(core::array& data) -> void;
-auto merge_sort(core::array& data) -> void;
-auto insertion_sort(core::array& data) -> void;
+template<typename Array>
+auto count_sort(Array& data) -> void;
+template<typename Array>
+auto bubble_sort(Array& data) -> void;
+template<typename Array>
+auto radix_sort(Array& data) -> void;
+template<typename Array>
+auto radix_sort_simple(Array& data) -> void;
+template<typename Array>
+auto parallel_radix_sort(Array& data) -> void;
+template<typename Array>
+auto american_flag_sort(Array& data) -> void;
+template<typename Array>
+auto quicksort(Array& data) -> void;
+template<typename Array>
+auto parallel_quicksort(Array& data) -> void;
+template<typename Array>
+auto samplesort(Array& data) -> void;
+template<typename Array>
+auto pdqsort(Array& data) -> void;
+template<typename Array>
+auto merge_sort(Array& data) -> void;
+template<typename Array>
+auto merge_sort_bottom_up(Array& data) -> void;
+template<typename Array>
+auto multiway_merge_sort(Array& data) -> void;
+template<typename Array>
+auto timsort(Array& data) -> void;
+template<typename Array>
+auto parallel_merge_sort(Array& data) -> void;
+template<typename Array>
+auto heap_sort(Array& data) -> void;
+template<typename Array>
+auto heap_sort_4ary(Array& data) -> void;
+template<typename Array>
+auto heap_sort_8ary(Array& data) -> void;
+template<typename Array>
+auto heap_sort_bottom_up(Array& data) -> void;
+template<typename Array>
+auto sorting_network(Array& data) -> void;
+template<typename Array>
+auto insertion_sort(Array& data) -> void;
 
 } // namespace core::algorithm
 
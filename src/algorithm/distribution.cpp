@@ -0,0 +1,271 @@
+#include "distribution.hpp"
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+
+namespace core {
+
+namespace {
+
+// Keys generated by one task, each block from its own generator.
+constexpr element_t g_block = element_t{ 1 } << 16U;
+// Distinct keys of `few_unique`, teeth of `sawtooth` and blocks of `staggered`.
+constexpr element_t g_groups = 16;
+// `nearly_sorted` swaps one pair per this many keys.
+constexpr element_t g_keys_per_swap = 100;
+// Most buckets `shuffled` scatters its keys to, so a bucket index fits in a byte.
+constexpr element_t g_shuffle_buckets = 256;
+
+// Spreads `seed` and `stream` over all bits (splitmix64), so neighbouring blocks get unrelated generators.
+[[nodiscard]] auto stream_seed(std::uint64_t const seed, std::uint64_t const stream) noexcept -> std::uint64_t
+{
+    constexpr std::uint64_t golden = 0x9e3779b97f4a7c15U;
+    constexpr std::uint64_t mul1 = 0xbf58476d1ce4e5b9U;
+    constexpr std::uint64_t mul2 = 0x94d049bb133111ebU;
+    constexpr unsigned shift1 = 30;
+    constexpr unsigned shift2 = 27;
+    constexpr unsigned shift3 = 31;
+
+    auto z = seed + (stream + 1) * golden;
+    z = (z ^ (z >> shift1)) * mul1;
+    z = (z ^ (z >> shift2)) * mul2;
+    return z ^ (z >> shift3);
+}
+
+// Calls `fill(first, last, rng)` for every block of `keys` on the task pool.
+template<typename F>
+auto fill_blocks(std::vector<element_t>& keys, std::uint64_t const seed, F const& fill) -> void
+{
+    auto const count = keys.size();
+    task_group group{ task_pool::instance() };
+
+    for(element_t first = 0; first < count; first += g_block) {
+        group.run([&fill, seed, count, first] {
+            std::mt19937_64 rng{ stream_seed(seed, first / g_block) };
+            fill(first, std::min(count, first + g_block), rng);
+        });
+    }
+
+    group.wait();
+}
+
+// Calls `key(i, rng)` for every key, in parallel blocks.
+template<typename F>
+auto generate_each(std::vector<element_t>& keys, std::uint64_t const seed, F const& key) -> void
+{
+    fill_blocks(keys, seed, [&keys, &key](element_t const first, element_t const last, std::mt19937_64& rng) {
+        for(auto i = first; i < last; ++i) {
+            keys[i] = key(i, rng);
+        }
+    });
+}
+
+// Calls `f(first, last)` for every block of `count` keys on the task pool.
+template<typename F>
+auto for_each_block(element_t const count, F const& f) -> void
+{
+    task_group group{ task_pool::instance() };
+
+    for(element_t first = 0; first < count; first += g_block) {
+        group.run([&f, count, first] { f(first, std::min(count, first + g_block)); });
+    }
+
+    group.wait();
+}
+
+// A uniformly random permutation of 1..count: every key goes to a random bucket, then every bucket is shuffled on
+// its own (Sanders, "Random permutations on distributed, external and hierarchical memory"). The buckets only
+// depend on the number of keys, so the thread count doesn't change the result.
+auto shuffle_keys(std::vector<element_t>& keys, std::uint64_t const seed) -> void
+{
+    auto const count = keys.size();
+    auto const blocks = (count + g_block - 1) / g_block;
+    auto const buckets = std::clamp<element_t>(blocks, 1, g_shuffle_buckets);
+
+    // keys of each block per bucket, turned into where the block scatters its keys of each bucket to
+    std::vector<element_t> offsets(blocks * buckets, 0);
+    std::vector<std::uint8_t> bucket_of(count);
+
+    fill_blocks(keys, seed, [&offsets, &bucket_of, buckets](element_t const first, element_t const last, auto& rng) {
+        std::uniform_int_distribution<element_t> pick{ 0, buckets - 1 };
+        auto* const block_offsets = &offsets[first / g_block * buckets];
+
+        for(auto i = first; i < last; ++i) {
+            bucket_of[i] = std::uint8_t(pick(rng));
+            ++block_offsets[bucket_of[i]]; // NOLINT
+        }
+    });
+
+    std::vector<element_t> bucket_begin(buckets + 1, 0);
+    element_t offset = 0;
+
+    for(element_t bucket = 0; bucket < buckets; ++bucket) {
+        bucket_begin[bucket] = offset;
+
+        for(element_t block = 0; block < blocks; ++block) {
+            offset += std::exchange(offsets[block * buckets + bucket], offset);
+        }
+    }
+
+    bucket_begin[buckets] = count;
+
+    for_each_block(count, [&keys, &offsets, &bucket_of, buckets](element_t const first, element_t const last) {
+        auto* const block_offsets = &offsets[first / g_block * buckets];
+
+        for(auto i = first; i < last; ++i) {
+            keys[block_offsets[bucket_of[i]]++] = i + 1; // NOLINT
+        }
+    });
+
+    task_group group{ task_pool::instance() };
+
+    for(element_t bucket = 0; bucket < buckets; ++bucket) {
+        group.run([&keys, &bucket_begin, seed, blocks, bucket] {
+            // streams past those of the blocks
+            std::mt19937_64 rng{ stream_seed(seed, blocks + bucket) };
+            std::shuffle(keys.begin() + std::ptrdiff_t(bucket_begin[bucket]),
+                         keys.begin() + std::ptrdiff_t(bucket_begin[bucket + 1]),
+                         rng);
+        });
+    }
+
+    group.wait();
+}
+
+} // namespace
+
+auto distribution_name(distribution const d) noexcept -> std::string_view
+{
+    switch(d) {
+    case distribution::shuffled:
+        return "shuffled";
+    case distribution::sorted:
+        return "sorted";
+    case distribution::reversed:
+        return "reversed";
+    case distribution::nearly_sorted:
+        return "nearly_sorted";
+    case distribution::few_unique:
+        return "few_unique";
+    case distribution::sawtooth:
+        return "sawtooth";
+    case distribution::organ_pipe:
+        return "organ_pipe";
+    case distribution::zipf:
+        return "zipf";
+    case distribution::gaussian:
+        return "gaussian";
+    case distribution::all_equal:
+        return "all_equal";
+    case distribution::staggered:
+        return "staggered";
+    }
+
+    return "unknown";
+}
+
+auto parse_distribution(std::string_view const name) noexcept -> std::optional<distribution>
+{
+    for(auto const d : g_distributions) {
+        if(distribution_name(d) == name) {
+            return d;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto generate_keys(distribution const d, element_t const count, std::uint64_t const seed) -> std::vector<element_t>
+{
+    std::vector<element_t> keys(count);
+
+    switch(d) {
+    case distribution::shuffled: {
+        shuffle_keys(keys, seed);
+        break;
+    }
+    case distribution::sorted: {
+        generate_each(keys, seed, [](element_t const i, std::mt19937_64&) { return i + 1; });
+        break;
+    }
+    case distribution::reversed: {
+        generate_each(keys, seed, [count](element_t const i, std::mt19937_64&) { return count - i; });
+        break;
+    }
+    case distribution::nearly_sorted: {
+        generate_each(keys, seed, [](element_t const i, std::mt19937_64&) { return i + 1; });
+
+        // swapped one after the other, pairs may overlap
+        std::mt19937_64 rng{ stream_seed(seed, count / g_block + 1) };
+
+        for(element_t swap = 0; count > 1 && swap < std::max<element_t>(1, count / g_keys_per_swap); ++swap) {
+            std::swap(keys[rng() % count], keys[rng() % count]);
+        }
+        break;
+    }
+    case distribution::few_unique: {
+        generate_each(keys, seed, [count](element_t, std::mt19937_64& rng) {
+            return 1 + rng() % g_groups * (count - 1) / (g_groups - 1);
+        });
+        break;
+    }
+    case distribution::sawtooth: {
+        auto const tooth = (count + g_groups - 1) / g_groups;
+        generate_each(keys, seed, [count, tooth](element_t const i, std::mt19937_64&) {
+            return 1 + i % tooth * count / tooth;
+        });
+        break;
+    }
+    case distribution::organ_pipe: {
+        generate_each(keys, seed, [count](element_t const i, std::mt19937_64&) {
+            return (i < (count + 1) / 2) ? 2 * i + 1 : 2 * (count - i);
+        });
+        break;
+    }
+    case distribution::zipf: {
+        // (count + 1)^u for a uniform u is log-uniform, the continuous Zipf distribution with exponent 1
+        auto const log_range = std::log(double(count) + 1.0);
+        fill_blocks(keys, seed, [&keys, count, log_range](element_t const first, element_t const last, auto& rng) {
+            std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+
+            for(auto i = first; i < last; ++i) {
+                keys[i] = std::min(count, element_t(std::exp(uniform(rng) * log_range))); // NOLINT
+            }
+        });
+        break;
+    }
+    case distribution::gaussian: {
+        constexpr double deviations = 8.0;
+        fill_blocks(keys, seed, [&keys, count](element_t const first, element_t const last, auto& rng) {
+            std::normal_distribution<double> normal{ double(count) / 2.0, double(count) / deviations };
+
+            for(auto i = first; i < last; ++i) {
+                keys[i] = element_t(std::clamp(std::round(normal(rng)), 1.0, double(count))); // NOLINT
+            }
+        });
+        break;
+    }
+    case distribution::all_equal: {
+        generate_each(keys, seed, [count](element_t, std::mt19937_64&) { return (count + 1) / 2; });
+        break;
+    }
+    case distribution::staggered: {
+        generate_each(keys, seed, [count](element_t const i, std::mt19937_64& rng) {
+            auto const block = i * g_groups / count;
+            auto const range = (block < g_groups / 2) ? 2 * block + 1 : 2 * block - g_groups;
+            auto const low = range * count / g_groups;
+            auto const width = std::max<element_t>(1, (range + 1) * count / g_groups - low);
+            return low + 1 + rng() % width;
+        });
+        break;
+    }
+    }
+
+    return keys;
+}
+
+} // namespace core
@@ -0,0 +1,56 @@
+#ifndef SORTVIS_DISTRIBUTION_HPP
+#define SORTVIS_DISTRIBUTION_HPP
+#pragma once
+
+#include "event/event.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+// Shapes of generated input. Every one of them fills `count` keys in [1, count].
+enum class distribution
+{
+    // a permutation of 1..count
+    shuffled,
+    sorted,
+    reversed,
+    // sorted, then count / 100 (at least one) random pairs swapped
+    nearly_sorted,
+    // 16 distinct keys in random order
+    few_unique,
+    // 16 ascending runs of the same keys
+    sawtooth,
+    // ascending to the middle, then descending
+    organ_pipe,
+    // Zipf with exponent 1, drawn from its continuous version: key k comes up about 1 / k as often as key 1
+    zipf,
+    // normal around count / 2, with a standard deviation of count / 8, clamped
+    gaussian,
+    all_equal,
+    // 16 blocks of random keys, each block from its own range, the ranges of the first half interleaved with those of
+    // the second
+    staggered
+};
+
+inline constexpr std::array<distribution, 11> g_distributions = {
+    distribution::shuffled,   distribution::sorted,   distribution::reversed,  distribution::nearly_sorted,
+    distribution::few_unique, distribution::sawtooth, distribution::organ_pipe, distribution::zipf,
+    distribution::gaussian,   distribution::all_equal, distribution::staggered
+};
+
+[[nodiscard]] auto distribution_name(distribution d) noexcept -> std::string_view;
+// The distribution `distribution_name` gives `name` for, if any.
+[[nodiscard]] auto parse_distribution(std::string_view name) noexcept -> std::optional<distribution>;
+
+// The same keys for a given seed, however many threads the task pool has. Blocks of keys are generated in parallel,
+// each from its own generator.
+[[nodiscard]] auto generate_keys(distribution d, element_t count, std::uint64_t seed) -> std::vector<element_t>;
+
+} // namespace core
+
+#endif // !SORTVIS_DISTRIBUTION_HPP
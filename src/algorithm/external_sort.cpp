@@ -0,0 +1,558 @@
+#include "external_sort.hpp"
+#include "log/log.hpp"
+#include "loser_tree.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#define SORTVIS_HAS_FSEEKO
+#endif
+
+namespace core {
+
+namespace {
+
+// Smallest block a merge reads or writes at a time, in keys. Fewer runs are merged at once rather than going below.
+constexpr std::size_t g_min_merge_block = 512;
+// Keys `write_random_keys` generates before writing them out.
+constexpr std::size_t g_generate_block = std::size_t{ 1 } << 16U;
+
+class key_file
+{
+private:
+    std::FILE* m_file{ nullptr };
+    std::string m_path;
+
+public:
+    key_file() = delete;
+    key_file(key_file const&) = delete;
+    key_file(key_file&&) = delete;
+
+    // Throws std::runtime_error if the file can't be opened.
+    key_file(std::string const& path, char const* const mode)
+        : m_file{ std::fopen(path.c_str(), mode) }
+        , m_path{ path }
+    {
+        if(m_file == nullptr) {
+            throw std::runtime_error{ "Couldn't open '" + path + "'" };
+        }
+    }
+
+    ~key_file() noexcept
+    {
+        if(m_file != nullptr && std::fclose(m_file) != 0) {
+            ERROR("Couldn't close '{}'", m_path);
+        }
+    }
+
+    auto operator=(key_file const&) -> key_file& = delete;
+    auto operator=(key_file&&) -> key_file& = delete;
+
+    // Reads up to `count` keys, fewer only at the end of the file.
+    [[nodiscard]] auto read(element_t* const keys, std::size_t const count) -> std::size_t
+    {
+        auto const read = std::fread(keys, sizeof(element_t), count, m_file);
+
+        if(read < count && std::ferror(m_file) != 0) {
+            throw std::runtime_error{ "Couldn't read from '" + m_path + "'" };
+        }
+
+        return read;
+    }
+
+    auto write(element_t const* const keys, std::size_t const count) -> void
+    {
+        if(count > 0 && std::fwrite(keys, sizeof(element_t), count, m_file) != count) {
+            throw std::runtime_error{ "Couldn't write to '" + m_path + "'" };
+        }
+    }
+
+    // Moves to the `index`th key, or the end of the file with `end`.
+    auto seek(std::uint64_t const index, bool const end = false) -> void
+    {
+        auto const origin = end ? SEEK_END : SEEK_SET;
+        auto const offset = end ? 0 : index * sizeof(element_t);
+#ifdef SORTVIS_HAS_FSEEKO
+        bool const failed = ::fseeko(m_file, static_cast<off_t>(offset), origin) != 0;
+#else
+        bool const failed = std::fseek(m_file, static_cast<long>(offset), origin) != 0;
+#endif
+
+        if(failed) {
+            throw std::runtime_error{ "Couldn't seek in '" + m_path + "'" };
+        }
+    }
+
+    [[nodiscard]] auto tell() const -> std::uint64_t
+    {
+#ifdef SORTVIS_HAS_FSEEKO
+        auto const position = ::ftello(m_file);
+#else
+        auto const position = std::ftell(m_file);
+#endif
+
+        if(position < 0) {
+            throw std::runtime_error{ "Couldn't find the size of '" + m_path + "'" };
+        }
+
+        return static_cast<std::uint64_t>(position) / sizeof(element_t);
+    }
+
+    // Closing flushes, so this is where a full disk shows up for files that were written.
+    auto close() -> void
+    {
+        if(std::fclose(std::exchange(m_file, nullptr)) != 0) {
+            throw std::runtime_error{ "Couldn't finish writing '" + m_path + "'" };
+        }
+    }
+};
+
+// Writes blocks of keys on another thread, so the caller can fill the next block meanwhile.
+class block_writer
+{
+private:
+    key_file m_file;
+    std::vector<element_t> m_writing{};
+    std::future<void> m_pending{};
+
+public:
+    block_writer() = delete;
+    block_writer(block_writer const&) = delete;
+    block_writer(block_writer&&) = delete;
+    ~block_writer() noexcept = default;
+
+    explicit block_writer(std::string const& path)
+        : m_file{ path, "wb" }
+    {
+    }
+
+    auto operator=(block_writer const&) -> block_writer& = delete;
+    auto operator=(block_writer&&) -> block_writer& = delete;
+
+    // Takes the keys in `keys` and leaves it empty, with the buffer of the block written before if there was one.
+    auto write(std::vector<element_t>& keys) -> void
+    {
+        this->wait();
+        std::swap(m_writing, keys);
+        keys.clear();
+
+        m_pending = std::async(std::launch::async, [this] { m_file.write(m_writing.data(), m_writing.size()); });
+    }
+
+    // Rethrows what the last write threw.
+    auto wait() -> void
+    {
+        if(m_pending.valid()) {
+            m_pending.get();
+        }
+    }
+
+    auto close() -> void
+    {
+        this->wait();
+        m_file.close();
+    }
+};
+
+struct run
+{
+    std::string path;
+    // where the run's keys are in the input
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+// Reads a run a block at a time, the next block is read on another thread while the current one is merged.
+class run_reader
+{
+private:
+    key_file m_file;
+    std::uint64_t m_unread{ 0 };
+    std::vector<element_t> m_current{};
+    std::vector<element_t> m_next{};
+    std::size_t m_position{ 0 };
+    std::size_t m_requested{ 0 };
+    std::future<std::size_t> m_pending{};
+
+    auto read_ahead() -> void
+    {
+        m_requested = static_cast<std::size_t>(std::min<std::uint64_t>(m_unread, m_next.size()));
+        m_unread -= m_requested;
+        m_pending = std::async(std::launch::async, [this] { return m_file.read(m_next.data(), m_requested); });
+    }
+
+    // Moves on to the block read ahead, returns false once the run is used up.
+    auto refill() -> bool
+    {
+        if(!m_pending.valid()) {
+            return false;
+        }
+
+        auto const count = m_pending.get();
+
+        if(count < m_requested) {
+            throw std::runtime_error{ "A run ended before all of its keys were read" };
+        }
+
+        auto const block = m_next.size();
+        std::swap(m_current, m_next);
+        m_current.resize(count);
+        m_next.resize(block);
+        m_position = 0;
+
+        if(m_unread > 0) {
+            this->read_ahead();
+        }
+
+        return count > 0;
+    }
+
+public:
+    run_reader() = delete;
+    run_reader(run_reader const&) = delete;
+    run_reader(run_reader&&) = delete;
+    ~run_reader() noexcept = default;
+
+    // `r` must not be empty.
+    run_reader(run const& r, std::size_t const block)
+        : m_file{ r.path, "rb" }
+        , m_unread{ r.size }
+        , m_next(block)
+    {
+        m_current.reserve(block);
+        this->read_ahead();
+        this->refill();
+    }
+
+    auto operator=(run_reader const&) -> run_reader& = delete;
+    auto operator=(run_reader&&) -> run_reader& = delete;
+
+    [[nodiscard]] auto head() const noexcept -> element_t
+    {
+        return m_current[m_position];
+    }
+
+    // Moves on to the next key, returns false once the run is used up.
+    auto pop() -> bool
+    {
+        if(++m_position < m_current.size()) {
+            return true;
+        }
+
+        return this->refill();
+    }
+};
+
+// Calls `on_sample` for the keys written at multiples of `sample_stride`, without dividing for every key.
+class sampler
+{
+private:
+    external_sort_config const& m_cfg;
+    external_phase m_phase;
+    std::uint64_t m_next{ std::numeric_limits<std::uint64_t>::max() };
+
+public:
+    sampler(external_sort_config const& cfg, external_phase const phase, std::uint64_t const first)
+        : m_cfg{ cfg }
+        , m_phase{ phase }
+    {
+        if(cfg.sample_stride > 0 && cfg.on_sample) {
+            m_next = (first + cfg.sample_stride - 1) / cfg.sample_stride * cfg.sample_stride;
+        }
+    }
+
+    auto operator()(std::uint64_t const position, element_t const key) -> void
+    {
+        if(position == m_next) {
+            m_cfg.on_sample(m_phase, position, key);
+            m_next += m_cfg.sample_stride;
+        }
+    }
+};
+
+// Names the runs of a sort and removes whichever of them are left when it goes away, so a sort that throws doesn't
+// leave them behind. Runs already merged or moved to the output are gone by then.
+class run_files
+{
+private:
+    std::string m_prefix;
+    std::vector<std::string> m_paths{};
+
+public:
+    run_files() = delete;
+    run_files(run_files const&) = delete;
+    run_files(run_files&&) = delete;
+
+    explicit run_files(std::string const& output_path)
+        : m_prefix{ output_path + ".run" }
+    {
+    }
+
+    ~run_files() noexcept
+    {
+        for(auto const& path : m_paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    auto operator=(run_files const&) -> run_files& = delete;
+    auto operator=(run_files&&) -> run_files& = delete;
+
+    // `<output_path>.run<N>`, removed later even if it's never created.
+    [[nodiscard]] auto next() -> std::string const&
+    {
+        m_paths.push_back(m_prefix + std::to_string(m_paths.size()));
+        return m_paths.back();
+    }
+};
+
+// Sorts chunks of the input into runs. While a run is sorted the next chunk is read and the run before is written,
+// so at most a read buffer, the array a run is sorted in and a write buffer are held at once.
+[[nodiscard]] auto form_runs(external_sort_config const& cfg, run_files& files) -> std::vector<run>
+{
+    constexpr std::size_t bytes_per_key = 2 * sizeof(element_t) + sizeof(silent_array::value_type);
+
+    key_file input{ cfg.input_path, "rb" };
+    std::vector<element_t> next(std::max<std::size_t>(cfg.memory_limit / bytes_per_key, 1));
+    std::vector<element_t> keys{};
+    std::unique_ptr<block_writer> writer{};
+    std::vector<run> runs{};
+    std::uint64_t offset = 0;
+
+    auto read_ahead = [&input, &next] {
+        return std::async(std::launch::async, [&input, &next] { return input.read(next.data(), next.size()); });
+    };
+
+    auto reading = read_ahead();
+
+    for(;;) {
+        auto const count = reading.get();
+
+        if(count == 0) {
+            break;
+        }
+
+        // only the last chunk comes up short, reading past it just finds the end of the file
+        next.resize(count);
+        silent_array data{ next };
+        reading = read_ahead();
+
+        cfg.sort(data);
+
+        if(writer != nullptr) {
+            writer->close();
+            writer.reset();
+        }
+
+        sampler sample{ cfg, external_phase::run_formation, offset };
+        keys.resize(count);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            keys[i] = data[i].get_raw();
+            sample(offset + i, keys[i]);
+        }
+
+        runs.push_back(run{ files.next(), offset, count });
+        writer = std::make_unique<block_writer>(runs.back().path);
+        writer->write(keys);
+        offset += count;
+    }
+
+    if(writer != nullptr) {
+        writer->close();
+    }
+
+    return runs;
+}
+
+// Merges `runs` into `target` through a loser tree of their heads, reading `block` keys of each run at a time.
+auto merge_runs(external_sort_config const& cfg, std::vector<run> const& runs, run const& target, std::size_t block)
+    -> void
+{
+    std::vector<std::unique_ptr<run_reader>> readers{};
+    loser_tree<element_t> heads{ runs.size() };
+
+    for(std::size_t r = 0; r < runs.size(); ++r) {
+        readers.push_back(std::make_unique<run_reader>(runs[r], block));
+        heads.set(r, readers.back()->head());
+    }
+
+    heads.build();
+
+    block_writer writer{ target.path };
+    std::vector<element_t> out{};
+    sampler sample{ cfg, external_phase::merge, target.offset };
+    std::uint64_t position = target.offset;
+
+    out.reserve(block);
+
+    while(!heads.empty()) {
+        auto const key = heads.top();
+        auto const r = heads.top_source();
+
+        sample(position++, key);
+        out.push_back(key);
+
+        if(out.size() == block) {
+            writer.write(out);
+            out.reserve(block);
+        }
+
+        if(readers[r]->pop()) {
+            heads.replace_top(readers[r]->head());
+        }
+        else {
+            heads.pop_top();
+        }
+    }
+
+    writer.write(out);
+    writer.close();
+    readers.clear();
+
+    for(auto const& r : runs) {
+        std::remove(r.path.c_str());
+    }
+}
+
+} // namespace
+
+auto external_sort(external_sort_config const& cfg) -> external_sort_result
+{
+    if(cfg.sort == nullptr) {
+        throw std::invalid_argument{ "An external sort needs an algorithm to sort its runs with" };
+    }
+
+    // every run merged takes a block being merged and one being read ahead, the output a block being filled and one
+    // being written
+    constexpr std::size_t bytes_per_block = 2 * sizeof(element_t);
+
+    std::size_t const block_pairs = cfg.memory_limit / (bytes_per_block * g_min_merge_block);
+    std::size_t const fan_in =
+        std::clamp<std::size_t>(block_pairs > 0 ? block_pairs - 1 : 0, 2, std::max<std::size_t>(cfg.max_fan_in, 2));
+    std::size_t const block = std::max<std::size_t>(cfg.memory_limit / ((fan_in + 1) * bytes_per_block), 1);
+
+    external_sort_result result{};
+    run_files files{ cfg.output_path };
+    auto runs = form_runs(cfg, files);
+
+    result.runs = runs.size();
+
+    for(auto const& r : runs) {
+        result.keys += r.size;
+    }
+
+    INFO("Sorted {} keys into {} runs, merging up to {} at once", result.keys, runs.size(), fan_in);
+
+    if(runs.empty()) {
+        key_file{ cfg.output_path, "wb" }.close();
+        return result;
+    }
+
+    while(runs.size() > 1) {
+        bool const last_pass = runs.size() <= fan_in;
+        std::vector<run> merged{};
+
+        ++result.merge_passes;
+
+        for(std::size_t first = 0; first < runs.size(); first += fan_in) {
+            auto const last = std::min(first + fan_in, runs.size());
+
+            // a run left over at the end waits for the next pass
+            if(last - first == 1) {
+                merged.push_back(runs[first]);
+                continue;
+            }
+
+            std::vector<run> const group(runs.begin() + static_cast<std::ptrdiff_t>(first),
+                                         runs.begin() + static_cast<std::ptrdiff_t>(last));
+            run target{ last_pass ? cfg.output_path : files.next(), group.front().offset, 0 };
+
+            for(auto const& r : group) {
+                target.size += r.size;
+            }
+
+            merge_runs(cfg, group, target, block);
+            merged.push_back(std::move(target));
+        }
+
+        runs = std::move(merged);
+    }
+
+    if(runs.front().path != cfg.output_path) {
+        std::remove(cfg.output_path.c_str());
+
+        if(std::rename(runs.front().path.c_str(), cfg.output_path.c_str()) != 0) {
+            throw std::runtime_error{ "Couldn't move the sorted run to '" + cfg.output_path + "'" };
+        }
+    }
+
+    return result;
+}
+
+auto key_file_size(std::string const& path) -> std::uint64_t
+{
+    key_file file{ path, "rb" };
+    file.seek(0, true);
+    return file.tell();
+}
+
+auto write_random_keys(std::string const& path, std::uint64_t const count, std::uint64_t const seed) -> void
+{
+    key_file file{ path, "wb" };
+    std::mt19937_64 rng{ seed };
+    std::uniform_int_distribution<element_t> key{ 1, std::max<element_t>(count, 1) };
+    std::vector<element_t> block(g_generate_block);
+
+    for(std::uint64_t written = 0; written < count;) {
+        auto const size = static_cast<std::size_t>(std::min<std::uint64_t>(count - written, block.size()));
+
+        std::generate_n(block.begin(), size, [&rng, &key] { return key(rng); });
+        file.write(block.data(), size);
+        written += size;
+    }
+
+    file.close();
+}
+
+auto sample_stride_for(std::uint64_t const keys, std::size_t const count) noexcept -> std::uint64_t
+{
+    if(count == 0) {
+        return std::max<std::uint64_t>(keys, 1);
+    }
+
+    return std::max<std::uint64_t>((keys + count - 1) / count, 1);
+}
+
+auto sample_key_file(std::string const& path, std::size_t const count) -> std::vector<element_t>
+{
+    auto const size = key_file_size(path);
+    auto const stride = sample_stride_for(size, count);
+    key_file file{ path, "rb" };
+    std::vector<element_t> samples{};
+
+    for(std::uint64_t position = 0; position < size; position += stride) {
+        element_t key{ 0 };
+
+        file.seek(position);
+
+        if(file.read(&key, 1) != 1) {
+            throw std::runtime_error{ "'" + path + "' ended while sampling it" };
+        }
+
+        samples.push_back(key);
+    }
+
+    return samples;
+}
+
+} // namespace core
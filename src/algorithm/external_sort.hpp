@@ -0,0 +1,64 @@
+#ifndef SORTVIS_EXTERNAL_SORT_HPP
+#define SORTVIS_EXTERNAL_SORT_HPP
+#pragma once
+
+#include "event/event.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Key files are plain arrays of native endian `element_t`s, without any header.
+
+enum class external_phase
+{
+    run_formation,
+    merge
+};
+
+struct external_sort_config
+{
+    std::string input_path{};
+    // Runs are kept next to it as `<output_path>.run<N>` while sorting.
+    std::string output_path{};
+    // Bytes of keys held in memory at once, counting the I/O buffers and the array a run is sorted in.
+    std::size_t memory_limit{ std::size_t{ 1 } << 28U };
+    // Sorts every run, the silent version of any algorithm.
+    void (*sort)(silent_array&){ nullptr };
+    // Most runs merged in one pass, fewer if their buffers wouldn't fit `memory_limit`.
+    std::size_t max_fan_in{ 64 };
+    // Every key written at a multiple of `sample_stride` is passed to `on_sample`, with where it was written. Runs
+    // are written where their keys were read from and a merge writes where its first run begins, so the final merge
+    // writes every key where it ends up. 0 reports nothing.
+    std::uint64_t sample_stride{ 0 };
+    std::function<void(external_phase, std::uint64_t, element_t)> on_sample{};
+};
+
+struct external_sort_result
+{
+    std::uint64_t keys{ 0 };
+    std::size_t runs{ 0 };
+    std::size_t merge_passes{ 0 };
+};
+
+// Sorts the key file at `input_path` into `output_path` without holding more than `memory_limit` bytes of it:
+// chunks that fit are sorted into runs, each one written while the next is read and sorted, then the runs are
+// merged, reading ahead in every run while the merge consumes the current block. Throws std::runtime_error if a
+// file can't be read or written, std::invalid_argument without a sort.
+[[nodiscard]] auto external_sort(external_sort_config const& cfg) -> external_sort_result;
+
+[[nodiscard]] auto key_file_size(std::string const& path) -> std::uint64_t;
+// Writes `count` random keys in [1, count], the same ones for a given seed, a block at a time.
+auto write_random_keys(std::string const& path, std::uint64_t count, std::uint64_t seed) -> void;
+// Distance between `count` evenly spaced keys out of `keys`, rounded up so there are at most `count`.
+[[nodiscard]] auto sample_stride_for(std::uint64_t keys, std::size_t count) noexcept -> std::uint64_t;
+// The keys at multiples of `sample_stride_for(size, count)`, for showing files too large to load.
+[[nodiscard]] auto sample_key_file(std::string const& path, std::size_t count) -> std::vector<element_t>;
+
+} // namespace core
+
+#endif // !SORTVIS_EXTERNAL_SORT_HPP
@@ -0,0 +1,352 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SORTVIS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace core {
+
+namespace {
+
+constexpr element_t g_byte_bits = 8;
+constexpr element_t g_byte_mask = 0xFF;
+
+// Consecutive keys are counted in different histograms, so a run of equal bytes doesn't make every increment wait
+// for the store of the previous one.
+constexpr std::size_t g_sub_histograms = 4;
+
+using sub_histograms = std::array<radix_histogram, g_sub_histograms>;
+
+auto merge_into(sub_histograms const& subs, radix_histogram& histogram) noexcept -> void
+{
+    for(std::size_t b = 0; b < histogram.size(); ++b) {
+        histogram[b] += subs[0][b] + subs[1][b] + subs[2][b] + subs[3][b];
+    }
+}
+
+// The kernels read either contiguous keys or the values of a silent array, and project the key out of each.
+[[nodiscard]] inline auto key_of(element_t const key) noexcept -> element_t
+{
+    return key;
+}
+
+[[nodiscard]] inline auto key_of(kernel_value const& value) noexcept -> element_t
+{
+    return value.get_raw();
+}
+
+template<typename Source>
+auto byte_histogram_scalar(Source const* keys,
+                           std::size_t const count,
+                           element_t const byte,
+                           radix_histogram& histogram) noexcept -> void
+{
+    sub_histograms subs{};
+    element_t const shift = byte * g_byte_bits;
+    std::size_t i = 0;
+
+    for(; i + g_sub_histograms <= count; i += g_sub_histograms) {
+        for(std::size_t k = 0; k < g_sub_histograms; ++k) {
+            ++subs[k][(key_of(keys[i + k]) >> shift) & g_byte_mask];
+        }
+    }
+
+    for(; i < count; ++i) {
+        ++subs[0][(key_of(keys[i]) >> shift) & g_byte_mask];
+    }
+
+    merge_into(subs, histogram);
+}
+
+template<typename Source>
+auto value_histogram_scalar(Source const* keys,
+                            std::size_t const count,
+                            element_t const min,
+                            element_t* counts) noexcept -> void
+{
+    for(std::size_t i = 0; i < count; ++i) {
+        ++counts[key_of(keys[i]) - min];
+    }
+}
+
+#ifdef SORTVIS_X86_KERNELS
+
+// The vector loads read a value as its key followed by its index. The vector types may alias anything, so they read
+// the values' bytes rather than pretending there was an array of keys.
+static_assert(std::is_standard_layout_v<kernel_value> && sizeof(kernel_value) == 2 * sizeof(element_t));
+
+// Loads four keys, not necessarily in order.
+__attribute__((target("avx2"))) inline auto load4(element_t const* keys) noexcept -> __m256i
+{
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys)); // NOLINT
+}
+
+__attribute__((target("avx2"))) inline auto load4(kernel_value const* values) noexcept -> __m256i
+{
+    // [k0 i0 k1 i1] and [k2 i2 k3 i3] give [k0 k2 k1 k3]
+    return _mm256_unpacklo_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(values)),      // NOLINT
+                                 _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values + 2))); // NOLINT
+}
+
+// Loads two keys in order.
+__attribute__((target("sse4.1"))) inline auto load2(element_t const* keys) noexcept -> __m128i
+{
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(keys)); // NOLINT
+}
+
+__attribute__((target("sse4.1"))) inline auto load2(kernel_value const* values) noexcept -> __m128i
+{
+    return _mm_unpacklo_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values)),      // NOLINT
+                              _mm_loadu_si128(reinterpret_cast<__m128i const*>(values + 1))); // NOLINT
+}
+
+template<typename Source>
+__attribute__((target("avx2"))) auto byte_histogram_avx2(Source const* keys,
+                                                         std::size_t const count,
+                                                         element_t const byte,
+                                                         radix_histogram& histogram) noexcept -> void
+{
+    sub_histograms subs{};
+    auto const shift = _mm_cvtsi64_si128(static_cast<long long>(byte * g_byte_bits));
+    auto const mask = _mm256_set1_epi64x(static_cast<long long>(g_byte_mask));
+    std::size_t i = 0;
+
+    for(; i + g_sub_histograms <= count; i += g_sub_histograms) {
+        auto const bytes = _mm256_and_si256(_mm256_srl_epi64(load4(keys + i), shift), mask);
+        auto const low = _mm256_castsi256_si128(bytes);
+        auto const high = _mm256_extracti128_si256(bytes, 1);
+
+        ++subs[0][static_cast<element_t>(_mm_cvtsi128_si64(low))];
+        ++subs[1][static_cast<element_t>(_mm_extract_epi64(low, 1))];
+        ++subs[2][static_cast<element_t>(_mm_cvtsi128_si64(high))];
+        ++subs[3][static_cast<element_t>(_mm_extract_epi64(high, 1))];
+    }
+
+    merge_into(subs, histogram);
+    byte_histogram_scalar(keys + i, count - i, byte, histogram);
+}
+
+template<typename Source>
+__attribute__((target("sse4.1"))) auto byte_histogram_sse4(Source const* keys,
+                                                           std::size_t const count,
+                                                           element_t const byte,
+                                                           radix_histogram& histogram) noexcept -> void
+{
+    sub_histograms subs{};
+    auto const shift = _mm_cvtsi64_si128(static_cast<long long>(byte * g_byte_bits));
+    auto const mask = _mm_set1_epi64x(static_cast<long long>(g_byte_mask));
+    std::size_t i = 0;
+
+    for(; i + g_sub_histograms <= count; i += g_sub_histograms) {
+        auto const low = _mm_and_si128(_mm_srl_epi64(load2(keys + i), shift), mask);
+        auto const high = _mm_and_si128(_mm_srl_epi64(load2(keys + i + 2), shift), mask);
+
+        ++subs[0][static_cast<element_t>(_mm_cvtsi128_si64(low))];
+        ++subs[1][static_cast<element_t>(_mm_extract_epi64(low, 1))];
+        ++subs[2][static_cast<element_t>(_mm_cvtsi128_si64(high))];
+        ++subs[3][static_cast<element_t>(_mm_extract_epi64(high, 1))];
+    }
+
+    merge_into(subs, histogram);
+    byte_histogram_scalar(keys + i, count - i, byte, histogram);
+}
+
+// A group of equal keys, common with skewed input, is counted with a single increment instead of a chain of
+// dependent ones.
+template<typename Source>
+__attribute__((target("avx2"))) auto value_histogram_avx2(Source const* keys,
+                                                          std::size_t const count,
+                                                          element_t const min,
+                                                          element_t* counts) noexcept -> void
+{
+    constexpr std::size_t group = 4;
+    constexpr int all_equal = -1;
+    auto const base = _mm256_set1_epi64x(static_cast<long long>(min));
+    std::size_t i = 0;
+
+    for(; i + group <= count; i += group) {
+        auto const v = _mm256_sub_epi64(load4(keys + i), base);
+        auto const equal = _mm256_cmpeq_epi64(v, _mm256_permute4x64_epi64(v, 0));
+        auto const low = _mm256_castsi256_si128(v);
+        auto const first = static_cast<element_t>(_mm_cvtsi128_si64(low));
+
+        if(_mm256_movemask_epi8(equal) == all_equal) {
+            counts[first] += group;
+            continue;
+        }
+
+        auto const high = _mm256_extracti128_si256(v, 1);
+
+        ++counts[first];
+        ++counts[static_cast<element_t>(_mm_extract_epi64(low, 1))];
+        ++counts[static_cast<element_t>(_mm_cvtsi128_si64(high))];
+        ++counts[static_cast<element_t>(_mm_extract_epi64(high, 1))];
+    }
+
+    value_histogram_scalar(keys + i, count - i, min, counts);
+}
+
+template<typename Source>
+__attribute__((target("sse4.1"))) auto value_histogram_sse4(Source const* keys,
+                                                            std::size_t const count,
+                                                            element_t const min,
+                                                            element_t* counts) noexcept -> void
+{
+    constexpr std::size_t group = 2;
+    constexpr int all_equal = 0xFFFF;
+    constexpr int broadcast_low = 0x44;
+    auto const base = _mm_set1_epi64x(static_cast<long long>(min));
+    std::size_t i = 0;
+
+    for(; i + group <= count; i += group) {
+        auto const v = _mm_sub_epi64(load2(keys + i), base);
+        auto const equal = _mm_cmpeq_epi64(v, _mm_shuffle_epi32(v, broadcast_low));
+        auto const first = static_cast<element_t>(_mm_cvtsi128_si64(v));
+
+        if(_mm_movemask_epi8(equal) == all_equal) {
+            counts[first] += group;
+            continue;
+        }
+
+        ++counts[first];
+        ++counts[static_cast<element_t>(_mm_extract_epi64(v, 1))];
+    }
+
+    value_histogram_scalar(keys + i, count - i, min, counts);
+}
+
+#endif
+
+template<typename Source>
+auto dispatch_byte_histogram(Source const* keys,
+                             std::size_t const count,
+                             element_t const byte,
+                             radix_histogram& histogram) -> void
+{
+#ifdef SORTVIS_X86_KERNELS
+    switch(current_simd_level()) {
+    case simd_level::avx2:
+        return byte_histogram_avx2(keys, count, byte, histogram);
+    case simd_level::sse4:
+        return byte_histogram_sse4(keys, count, byte, histogram);
+    case simd_level::scalar:
+        break;
+    }
+#endif
+
+    byte_histogram_scalar(keys, count, byte, histogram);
+}
+
+template<typename Source>
+auto dispatch_value_histogram(Source const* keys, std::size_t const count, element_t const min, element_t* counts)
+    -> void
+{
+#ifdef SORTVIS_X86_KERNELS
+    switch(current_simd_level()) {
+    case simd_level::avx2:
+        return value_histogram_avx2(keys, count, min, counts);
+    case simd_level::sse4:
+        return value_histogram_sse4(keys, count, min, counts);
+    case simd_level::scalar:
+        break;
+    }
+#endif
+
+    value_histogram_scalar(keys, count, min, counts);
+}
+
+// Two independent pairs of accumulators, so neither comparison chain waits on the other.
+template<typename Source>
+auto scalar_key_range(Source const* keys, std::size_t const count) noexcept -> std::pair<element_t, element_t>
+{
+    std::array<element_t, 2> min{ key_of(keys[0]), key_of(keys[0]) };
+    std::array<element_t, 2> max{ key_of(keys[0]), key_of(keys[0]) };
+    std::size_t i = 1;
+
+    for(; i + 2 <= count; i += 2) {
+        for(std::size_t k = 0; k < 2; ++k) {
+            min[k] = std::min(min[k], key_of(keys[i + k]));
+            max[k] = std::max(max[k], key_of(keys[i + k]));
+        }
+    }
+
+    for(; i < count; ++i) {
+        min[0] = std::min(min[0], key_of(keys[i]));
+        max[0] = std::max(max[0], key_of(keys[i]));
+    }
+
+    return { std::min(min[0], min[1]), std::max(max[0], max[1]) };
+}
+
+[[nodiscard]] auto detect_simd_level() noexcept -> simd_level
+{
+#ifdef SORTVIS_X86_KERNELS
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")) {
+        return simd_level::avx2;
+    }
+    if(__builtin_cpu_supports("sse4.1")) {
+        return simd_level::sse4;
+    }
+#endif
+
+    return simd_level::scalar;
+}
+
+std::atomic<simd_level> g_simd_level{ supported_simd_level() };
+
+} // namespace
+
+auto supported_simd_level() noexcept -> simd_level
+{
+    static simd_level const level = detect_simd_level();
+    return level;
+}
+
+auto set_simd_level(simd_level const level) noexcept -> void
+{
+    g_simd_level.store(std::min(level, supported_simd_level()), std::memory_order_relaxed);
+}
+
+auto current_simd_level() noexcept -> simd_level
+{
+    return g_simd_level.load(std::memory_order_relaxed);
+}
+
+auto byte_histogram(element_t const* keys, std::size_t const count, element_t const byte, radix_histogram& histogram)
+    -> void
+{
+    dispatch_byte_histogram(keys, count, byte, histogram);
+}
+
+auto byte_histogram(kernel_value const* values,
+                    std::size_t const count,
+                    element_t const byte,
+                    radix_histogram& histogram) -> void
+{
+    dispatch_byte_histogram(values, count, byte, histogram);
+}
+
+auto value_histogram(element_t const* keys, std::size_t const count, element_t const min, element_t* counts) -> void
+{
+    dispatch_value_histogram(keys, count, min, counts);
+}
+
+auto value_histogram(kernel_value const* values, std::size_t const count, element_t const min, element_t* counts)
+    -> void
+{
+    dispatch_value_histogram(values, count, min, counts);
+}
+
+auto key_range(kernel_value const* values, std::size_t const count) noexcept -> std::pair<element_t, element_t>
+{
+    return scalar_key_range(values, count);
+}
+
+} // namespace core
@@ -0,0 +1,46 @@
+#ifndef SORTVIS_HISTOGRAM_HPP
+#define SORTVIS_HISTOGRAM_HPP
+#pragma once
+
+#include "event/event.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace core {
+
+// Counts per value of a key byte.
+using radix_histogram = std::array<element_t, 256>;
+
+// Instruction sets the histogram kernels can use, the best one the CPU supports is picked at startup.
+enum class simd_level
+{
+    scalar,
+    sse4,
+    avx2
+};
+
+[[nodiscard]] auto supported_simd_level() noexcept -> simd_level;
+// Levels above the supported one are clamped to it. Mostly there to compare the kernels against each other.
+auto set_simd_level(simd_level level) noexcept -> void;
+[[nodiscard]] auto current_simd_level() noexcept -> simd_level;
+
+// What the kernels read from a silent array of `element_t`, see `basic_array::data()`.
+using kernel_value = silent_array::value_type;
+
+// Adds the `byte`th byte of `count` keys to `histogram`.
+auto byte_histogram(element_t const* keys, std::size_t count, element_t byte, radix_histogram& histogram) -> void;
+auto byte_histogram(kernel_value const* values, std::size_t count, element_t byte, radix_histogram& histogram)
+    -> void;
+// Adds how often each of `count` keys occurs to `counts`, where key `k` is counted at `counts[k - min]`. No key may
+// be smaller than `min` or index past the end of `counts`.
+auto value_histogram(element_t const* keys, std::size_t count, element_t min, element_t* counts) -> void;
+auto value_histogram(kernel_value const* values, std::size_t count, element_t min, element_t* counts) -> void;
+// Smallest and largest of the keys of `count` > 0 values.
+[[nodiscard]] auto key_range(kernel_value const* values, std::size_t count) noexcept
+    -> std::pair<element_t, element_t>;
+
+} // namespace core
+
+#endif // !SORTVIS_HISTOGRAM_HPP
@@ -0,0 +1,135 @@
+#ifndef SORTVIS_LOSER_TREE_HPP
+#define SORTVIS_LOSER_TREE_HPP
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+// Tournament tree for merging k sorted sources. Every inner node keeps the loser of the match played there and the
+// overall winner is kept on top, so replacing the winner with the next key of its source only replays the matches
+// on the way from its leaf to the root: log2(k) comparisons, each against a single stored loser. A source that runs
+// out is flagged as a sentinel that loses every match; `beats` checks the flags before comparing keys, so `Key`
+// doesn't need a value that sorts after every real key. Equal keys go to the source with the lower index first, so
+// merging adjacent runs in order is stable.
+template<typename Key, typename Less = std::less<Key>>
+class loser_tree
+{
+private:
+    // leaves, rounded up to a power of two, the extra ones are sentinels from the start
+    std::size_t m_leaves{ 1 };
+    // m_nodes[0] is the winner, m_nodes[n] the loser of the match at inner node n, whose children are 2n and 2n + 1
+    std::vector<std::size_t> m_nodes{};
+    std::vector<Key> m_keys{};
+    std::vector<std::uint8_t> m_sentinel{};
+    // winners of every match while building, kept so building again doesn't allocate
+    std::vector<std::size_t> m_winners{};
+    Less m_less{};
+
+    // Whether the current key of `a` goes out before the one of `b`.
+    [[nodiscard]] auto beats(std::size_t const a, std::size_t const b) const -> bool
+    {
+        if(m_sentinel[a] != 0 || m_sentinel[b] != 0) {
+            return m_sentinel[a] == 0 && (m_sentinel[b] != 0 || a < b);
+        }
+
+        // one comparison per match, a tie goes to the lower index
+        return a < b ? !m_less(m_keys[b], m_keys[a]) : m_less(m_keys[a], m_keys[b]);
+    }
+
+    auto replay(std::size_t winner) -> void
+    {
+        for(std::size_t node = (m_leaves + winner) / 2; node > 0; node /= 2) {
+            if(this->beats(m_nodes[node], winner)) {
+                std::swap(m_nodes[node], winner);
+            }
+        }
+
+        m_nodes[0] = winner;
+    }
+
+public:
+    // Every source starts out as a sentinel, give them their first keys with `set` and then `build`.
+    explicit loser_tree(std::size_t const sources, Less less = {})
+        : m_less{ std::move(less) }
+    {
+        while(m_leaves < sources) {
+            m_leaves *= 2;
+        }
+
+        m_nodes.resize(m_leaves);
+        m_keys.resize(m_leaves);
+        m_sentinel.assign(m_leaves, 1);
+        m_winners.resize(2 * m_leaves);
+    }
+
+    auto set(std::size_t const source, Key key) -> void
+    {
+        m_keys[source] = std::move(key);
+        m_sentinel[source] = 0;
+    }
+
+    // Makes every source a sentinel again, to merge other sources with the same tree.
+    auto clear() -> void
+    {
+        std::fill(m_sentinel.begin(), m_sentinel.end(), std::uint8_t{ 1 });
+    }
+
+    // Plays the whole tournament, once every source has its first key.
+    auto build() -> void
+    {
+        for(std::size_t leaf = 0; leaf < m_leaves; ++leaf) {
+            m_winners[m_leaves + leaf] = leaf;
+        }
+
+        for(std::size_t node = m_leaves - 1; node > 0; --node) {
+            auto const left = m_winners[2 * node];
+            auto const right = m_winners[2 * node + 1];
+            bool const left_wins = this->beats(left, right);
+
+            m_winners[node] = left_wins ? left : right;
+            m_nodes[node] = left_wins ? right : left;
+        }
+
+        m_nodes[0] = m_winners[1];
+    }
+
+    // Whether every source ran out.
+    [[nodiscard]] auto empty() const -> bool
+    {
+        return m_sentinel[m_nodes[0]] != 0;
+    }
+
+    [[nodiscard]] auto top() const -> Key const&
+    {
+        return m_keys[m_nodes[0]];
+    }
+
+    [[nodiscard]] auto top_source() const noexcept -> std::size_t
+    {
+        return m_nodes[0];
+    }
+
+    // Replaces the winner with the next key of its source.
+    auto replace_top(Key key) -> void
+    {
+        m_keys[m_nodes[0]] = std::move(key);
+        this->replay(m_nodes[0]);
+    }
+
+    // Takes the winner's source out of the tournament, it ran out of keys.
+    auto pop_top() -> void
+    {
+        m_sentinel[m_nodes[0]] = 1;
+        this->replay(m_nodes[0]);
+    }
+};
+
+} // namespace core
+
+#endif // !SORTVIS_LOSER_TREE_HPP
@@ -5,9 +5,21 @@
 
 namespace core {
 
+auto random_seed() -> std::uint64_t
+{
+    std::random_device device{};
+    constexpr unsigned int bits_per_call = 32;
+    return (std::uint64_t{ device() } << bits_per_call) | device();
+}
+
 auto random_shuffle(std::vector<element_t>& data) -> void
 {
-    std::mt19937 rng{ std::random_device{}() };
+    random_shuffle(data, random_seed());
+}
+
+auto random_shuffle(std::vector<element_t>& data, std::uint64_t const seed) -> void
+{
+    std::mt19937_64 rng{ seed };
     std::shuffle(data.begin(), data.end(), rng);
 }
 
@@ -4,9 +4,15 @@
 
 #include "event/event.hpp"
 
+#include <cstdint>
+
 namespace core {
 
+[[nodiscard]] auto random_seed() -> std::uint64_t;
+
 auto random_shuffle(std::vector<element_t>& data) -> void;
+// Shuffles the same way every time for a given seed.
+auto random_shuffle(std::vector<element_t>& data, std::uint64_t seed) -> void;
 
 } // namespace core
 
@@ -0,0 +1,83 @@
+#include "sorting_network.hpp"
+
+namespace core {
+
+namespace {
+
+// Sizes 0 and 1 included, their networks are empty.
+constexpr std::size_t g_network_sizes = max_network_size + 1;
+
+// Picks both outputs with selects on one comparison rather than branching on it, which compiles to conditional moves.
+template<typename Key>
+[[gnu::always_inline]] inline auto compare_exchange(Key* keys, std::size_t const low, std::size_t const high) noexcept
+    -> void
+{
+    auto const a = keys[low];
+    auto const b = keys[high];
+    bool const swap = b < a;
+
+    keys[low] = swap ? b : a;
+    keys[high] = swap ? a : b;
+}
+
+// The keys are copied into a local array first: with every index a constant the compiler keeps them in registers
+// instead of storing each output and loading it back for the next comparator.
+template<typename Key, std::size_t N, std::size_t... I>
+auto sort_unrolled(Key* keys, std::index_sequence<I...>) noexcept -> void
+{
+    std::array<Key, N> local{};
+    std::copy_n(keys, N, local.begin());
+
+    (compare_exchange(local.data(), network<N>[I].low, network<N>[I].high), ...);
+
+    std::copy_n(local.begin(), N, keys);
+}
+
+template<typename Key, std::size_t N>
+auto sort_unrolled(Key* keys) noexcept -> void
+{
+    sort_unrolled<Key, N>(keys, std::make_index_sequence<network<N>.size()>{});
+}
+
+template<typename Key>
+using kernel = void (*)(Key*) noexcept;
+
+template<typename Key, std::size_t... N>
+[[nodiscard]] constexpr auto make_kernels(std::index_sequence<N...>) -> std::array<kernel<Key>, sizeof...(N)>
+{
+    return { &sort_unrolled<Key, N>... };
+}
+
+template<std::size_t... N>
+[[nodiscard]] constexpr auto make_tables(std::index_sequence<N...>)
+    -> std::array<std::pair<comparator const*, std::size_t>, sizeof...(N)>
+{
+    return { std::pair{ network<N>.data(), network<N>.size() }... };
+}
+
+template<typename Key>
+constexpr auto g_kernels = make_kernels<Key>(std::make_index_sequence<g_network_sizes>{});
+constexpr auto g_tables = make_tables(std::make_index_sequence<g_network_sizes>{});
+
+} // namespace
+
+auto network_comparators(std::size_t const n) noexcept -> std::pair<comparator const*, std::size_t>
+{
+    return g_tables[n];
+}
+
+template<typename Key>
+auto network_sort(Key* keys, std::size_t const n) noexcept -> void
+{
+    g_kernels<Key>[n](keys);
+}
+
+template auto network_sort(element_t* keys, std::size_t n) noexcept -> void;
+template auto network_sort(std::uint32_t* keys, std::size_t n) noexcept -> void;
+template auto network_sort(std::int32_t* keys, std::size_t n) noexcept -> void;
+template auto network_sort(std::int64_t* keys, std::size_t n) noexcept -> void;
+template auto network_sort(float* keys, std::size_t n) noexcept -> void;
+template auto network_sort(double* keys, std::size_t n) noexcept -> void;
+template auto network_sort(key_value* keys, std::size_t n) noexcept -> void;
+
+} // namespace core
@@ -0,0 +1,277 @@
+#ifndef SORTVIS_SORTING_NETWORK_HPP
+#define SORTVIS_SORTING_NETWORK_HPP
+#pragma once
+
+#include "event/event.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace core {
+
+// Compile-time tables exist for networks on up to this many inputs.
+inline constexpr std::size_t max_network_size = 32;
+
+// Orders the inputs `low` and `high` so the smaller one ends up at `low`. Comparators of the same layer touch
+// distinct inputs.
+struct comparator
+{
+    std::uint8_t low;
+    std::uint8_t high;
+    std::uint8_t layer;
+};
+
+// Calls `f(low, high, layer)` for every comparator of Batcher's odd-even merge sort network on `n` inputs, a layer
+// at a time. Works for any `n`, not only powers of two.
+template<typename F>
+constexpr auto for_each_comparator(std::size_t const n, F&& f) -> void
+{
+    std::size_t layer = 0;
+
+    for(std::size_t p = 1; p < n; p *= 2) {
+        for(std::size_t k = p; k >= 1; k /= 2) {
+            for(std::size_t j = k % p; j + k < n; j += 2 * k) {
+                for(std::size_t i = 0; i < std::min(k, n - j - k); ++i) {
+                    if((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        f(i + j, i + j + k, layer);
+                    }
+                }
+            }
+
+            ++layer;
+        }
+    }
+}
+
+// Batcher's networks are optimal up to 8 inputs. Above that these are the smallest networks known, from the searches
+// collected in Knuth's TAOCP 5.3.4 (Green's 60 comparators for 16 inputs) and later ones, one line per layer.
+// clang-format off
+inline constexpr std::array<std::array<std::uint8_t, 2>, 25> g_network_9 = { {
+    { 0, 3 }, { 1, 7 }, { 2, 5 }, { 4, 8 },
+    { 0, 7 }, { 2, 4 }, { 3, 8 }, { 5, 6 },
+    { 0, 2 }, { 1, 3 }, { 4, 5 }, { 7, 8 },
+    { 1, 4 }, { 3, 6 }, { 5, 7 },
+    { 0, 1 }, { 2, 4 }, { 3, 5 }, { 6, 8 },
+    { 2, 3 }, { 4, 5 }, { 6, 7 },
+    { 1, 2 }, { 3, 4 }, { 5, 6 }
+} };
+
+inline constexpr std::array<std::array<std::uint8_t, 2>, 29> g_network_10 = { {
+    { 0, 8 }, { 1, 9 }, { 2, 7 }, { 3, 5 }, { 4, 6 },
+    { 0, 2 }, { 1, 4 }, { 5, 8 }, { 7, 9 },
+    { 0, 3 }, { 2, 4 }, { 5, 7 }, { 6, 9 },
+    { 0, 1 }, { 3, 6 }, { 8, 9 },
+    { 1, 5 }, { 2, 3 }, { 4, 8 }, { 6, 7 },
+    { 1, 2 }, { 3, 5 }, { 4, 6 }, { 7, 8 },
+    { 2, 3 }, { 4, 5 }, { 6, 7 },
+    { 3, 4 }, { 5, 6 }
+} };
+
+inline constexpr std::array<std::array<std::uint8_t, 2>, 35> g_network_11 = { {
+    { 0, 9 }, { 1, 6 }, { 2, 4 }, { 3, 7 }, { 5, 8 },
+    { 0, 1 }, { 3, 5 }, { 4, 10 }, { 6, 9 }, { 7, 8 },
+    { 1, 3 }, { 2, 5 }, { 4, 7 }, { 8, 10 },
+    { 0, 4 }, { 1, 2 }, { 3, 7 }, { 5, 9 }, { 6, 8 },
+    { 0, 1 }, { 2, 6 }, { 4, 5 }, { 7, 8 }, { 9, 10 },
+    { 2, 4 }, { 3, 6 }, { 5, 7 }, { 8, 9 },
+    { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 },
+    { 2, 3 }, { 4, 5 }, { 6, 7 }
+} };
+
+inline constexpr std::array<std::array<std::uint8_t, 2>, 39> g_network_12 = { {
+    { 0, 8 }, { 1, 7 }, { 2, 6 }, { 3, 11 }, { 4, 10 }, { 5, 9 },
+    { 0, 1 }, { 2, 5 }, { 3, 4 }, { 6, 9 }, { 7, 8 }, { 10, 11 },
+    { 0, 2 }, { 1, 6 }, { 5, 10 }, { 9, 11 },
+    { 0, 3 }, { 1, 2 }, { 4, 6 }, { 5, 7 }, { 8, 11 }, { 9, 10 },
+    { 1, 4 }, { 3, 5 }, { 6, 8 }, { 7, 10 },
+    { 1, 3 }, { 2, 5 }, { 6, 9 }, { 8, 10 },
+    { 2, 3 }, { 4, 5 }, { 6, 7 }, { 8, 9 },
+    { 4, 6 }, { 5, 7 },
+    { 3, 4 }, { 5, 6 }, { 7, 8 }
+} };
+
+inline constexpr std::array<std::array<std::uint8_t, 2>, 60> g_network_16 = { {
+    { 0, 13 }, { 1, 12 }, { 2, 15 }, { 3, 14 }, { 4, 8 }, { 5, 6 }, { 7, 11 }, { 9, 10 },
+    { 0, 5 }, { 1, 7 }, { 2, 9 }, { 3, 4 }, { 6, 13 }, { 8, 14 }, { 10, 15 }, { 11, 12 },
+    { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 8 }, { 7, 9 }, { 10, 11 }, { 12, 13 }, { 14, 15 },
+    { 0, 2 }, { 1, 3 }, { 4, 10 }, { 5, 11 }, { 6, 7 }, { 8, 9 }, { 12, 14 }, { 13, 15 },
+    { 1, 2 }, { 3, 12 }, { 4, 6 }, { 5, 7 }, { 8, 10 }, { 9, 11 }, { 13, 14 },
+    { 1, 4 }, { 2, 6 }, { 5, 8 }, { 7, 10 }, { 9, 13 }, { 11, 14 },
+    { 2, 4 }, { 3, 6 }, { 9, 12 }, { 11, 13 },
+    { 3, 5 }, { 6, 8 }, { 7, 9 }, { 10, 12 },
+    { 3, 4 }, { 5, 6 }, { 7, 8 }, { 9, 10 }, { 11, 12 },
+    { 6, 7 }, { 8, 9 }
+} };
+// clang-format on
+
+// Comparators of a network under construction, in an order that keeps every input's comparators in sequence.
+struct network_builder
+{
+    static constexpr std::size_t capacity = 256;
+
+    std::array<comparator, capacity> comparators{};
+    std::size_t size{ 0 };
+
+    constexpr auto add(std::size_t const low, std::size_t const high) -> void
+    {
+        comparators[size++] = comparator{ std::uint8_t(low), std::uint8_t(high), 0 };
+    }
+
+    template<std::size_t Size>
+    constexpr auto add(std::array<std::array<std::uint8_t, 2>, Size> const& table, std::size_t const offset) -> void
+    {
+        for(auto const& [low, high] : table) {
+            this->add(low + offset, high + offset);
+        }
+    }
+
+    constexpr auto add(network_builder const& other, std::size_t const offset) -> void
+    {
+        for(std::size_t k = 0; k < other.size; ++k) {
+            this->add(other.comparators[k].low + offset, other.comparators[k].high + offset);
+        }
+    }
+};
+
+// The network on `n` inputs without its lowest `bottom` and highest `top` inputs. Those can be thought of as
+// holding -inf and +inf, which never move, so it sorts the others.
+[[nodiscard]] constexpr auto prune_network(network_builder const& network,
+                                           std::size_t const n,
+                                           std::size_t const bottom,
+                                           std::size_t const top) -> network_builder
+{
+    network_builder result{};
+
+    for(std::size_t k = 0; k < network.size; ++k) {
+        auto const& c = network.comparators[k];
+
+        if(c.low >= bottom && c.high + top < n) {
+            result.add(c.low - bottom, c.high - bottom);
+        }
+    }
+
+    return result;
+}
+
+// The smallest network on `n` <= `max_network_size` inputs this can put together: Batcher's up to 8 inputs, the
+// tables above, Green's network pruned for 13 to 15, and above 16 two such networks on the lower 16 and the
+// remaining inputs followed by the merge that ends Batcher's network, or the 32 input one pruned if that's smaller.
+// That matches the best known networks except for 13 inputs (one comparator more) and 17 to 30 (up to 8 more).
+[[nodiscard]] constexpr auto best_network(std::size_t const n) -> network_builder
+{
+    constexpr std::size_t half = max_network_size / 2;
+
+    network_builder result{};
+
+    switch(n) {
+    case 9:
+        result.add(g_network_9, 0);
+        return result;
+    case 10:
+        result.add(g_network_10, 0);
+        return result;
+    case 11:
+        result.add(g_network_11, 0);
+        return result;
+    case 12:
+        result.add(g_network_12, 0);
+        return result;
+    case half:
+        result.add(g_network_16, 0);
+        return result;
+    default:
+        break;
+    }
+
+    if(n <= 8) {
+        for_each_comparator(
+            n, [&result](std::size_t const low, std::size_t const high, std::size_t) { result.add(low, high); });
+        return result;
+    }
+    if(n < half) {
+        return prune_network(best_network(half), half, 0, half - n);
+    }
+
+    result.add(best_network(half), 0);
+    result.add(best_network(n - half), half);
+
+    // the last merge of Batcher's network: every layer past the ones that sort each half on their own
+    std::size_t half_layers = 0;
+    for_each_comparator(half, [&half_layers](std::size_t, std::size_t, std::size_t const layer) {
+        half_layers = layer + 1;
+    });
+    for_each_comparator(n, [&result, half_layers](std::size_t const low, std::size_t const high, auto const layer) {
+        if(layer >= half_layers) {
+            result.add(low, high);
+        }
+    });
+
+    if(n < max_network_size) {
+        auto const full = best_network(max_network_size);
+
+        for(std::size_t bottom = 0; bottom <= max_network_size - n; ++bottom) {
+            auto const pruned = prune_network(full, max_network_size, bottom, max_network_size - n - bottom);
+
+            if(pruned.size < result.size) {
+                result = pruned;
+            }
+        }
+    }
+
+    return result;
+}
+
+template<std::size_t N>
+[[nodiscard]] constexpr auto make_network() -> std::array<comparator, best_network(N).size>
+{
+    static_assert(N <= max_network_size);
+
+    constexpr auto built = best_network(N);
+
+    // every comparator goes one layer past the last one on either of its inputs, then they're ordered by layer
+    std::array<comparator, built.size> layered{};
+    std::array<std::size_t, max_network_size> next_layer{};
+    std::size_t layers = 0;
+
+    for(std::size_t k = 0; k < built.size; ++k) {
+        auto c = built.comparators[k];
+        auto const layer = std::max(next_layer[c.low], next_layer[c.high]);
+
+        c.layer = std::uint8_t(layer);
+        next_layer[c.low] = layer + 1;
+        next_layer[c.high] = layer + 1;
+        layers = std::max(layers, layer + 1);
+        layered[k] = c;
+    }
+
+    std::array<comparator, built.size> result{};
+    std::size_t next = 0;
+
+    for(std::size_t layer = 0; layer < layers; ++layer) {
+        for(auto const& c : layered) {
+            if(c.layer == layer) {
+                result[next++] = c;
+            }
+        }
+    }
+
+    return result;
+}
+
+template<std::size_t N>
+inline constexpr auto network = make_network<N>();
+
+// The comparators of the network on `n` <= `max_network_size` inputs.
+[[nodiscard]] auto network_comparators(std::size_t n) noexcept -> std::pair<comparator const*, std::size_t>;
+
+// Sorts `n` <= `max_network_size` contiguous keys. The network is unrolled into straight-line compare-exchanges on
+// keys held in registers, no comparison is ever branched on. Instantiated for the key types of the silent arrays.
+template<typename Key>
+auto network_sort(Key* keys, std::size_t n) noexcept -> void;
+
+} // namespace core
+
+#endif // !SORTVIS_SORTING_NETWORK_HPP
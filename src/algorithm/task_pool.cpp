@@ -0,0 +1,243 @@
+#include "task_pool.hpp"
+#include "log/log.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace core {
+
+namespace {
+
+std::atomic<task_pool*> g_instance{ nullptr };
+
+// the pool the calling thread works for and the index of its queue there
+thread_local task_pool const* t_pool = nullptr;
+thread_local std::size_t t_queue = 0;
+
+} // namespace
+
+task_pool::task_pool(std::size_t const num_workers)
+{
+    m_queues.reserve(num_workers + 1);
+
+    for(std::size_t i = 0; i <= num_workers; ++i) {
+        m_queues.push_back(std::make_unique<task_queue>());
+    }
+
+    m_workers.reserve(num_workers);
+
+    for(std::size_t i = 0; i < num_workers; ++i) {
+        m_workers.emplace_back([this, i] { this->worker_loop(i); });
+    }
+}
+
+task_pool::~task_pool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> guard{ m_sleep_lock };
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+
+    m_wake.notify_all();
+
+    for(auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+auto task_pool::instance() -> task_pool&
+{
+    if(auto* const pool = g_instance.load(std::memory_order_acquire); pool != nullptr) {
+        return *pool;
+    }
+
+    // Never destroyed: its workers may still hand events over to `event_manager` while statics are torn down.
+    static auto* const default_pool = new task_pool{ std::max(std::thread::hardware_concurrency(), 1U) - 1 }; // NOLINT
+    return *default_pool;
+}
+
+auto task_pool::set_instance(task_pool* const pool) noexcept -> void
+{
+    g_instance.store(pool, std::memory_order_release);
+}
+
+auto task_pool::num_workers() const noexcept -> std::size_t
+{
+    return m_workers.size();
+}
+
+auto task_pool::concurrency() const noexcept -> std::size_t
+{
+    return m_workers.size() + 1;
+}
+
+auto task_pool::own_queue() const noexcept -> std::size_t
+{
+    return (t_pool == this) ? t_queue : m_queues.size() - 1;
+}
+
+auto task_pool::try_pop(std::size_t const queue, bool const from_back, task& out) -> bool
+{
+    auto& q = *m_queues[queue];
+    std::lock_guard<std::mutex> guard{ q.lock };
+
+    if(q.tasks.empty()) {
+        return false;
+    }
+
+    if(from_back) {
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+    }
+    else {
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+    }
+
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+auto task_pool::submit(task t) -> void
+{
+    // Counted before it can be popped, so the decrement in `try_pop` never comes first and wraps the count. Both
+    // sides use read-modify-writes, so either a sleeping worker is seen below or it sees the new task.
+    m_pending.fetch_add(1, std::memory_order_seq_cst);
+
+    {
+        auto& q = *m_queues[this->own_queue()];
+        std::lock_guard<std::mutex> guard{ q.lock };
+        q.tasks.push_back(std::move(t));
+    }
+
+    if(m_sleeping.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> guard{ m_sleep_lock };
+        }
+
+        m_wake.notify_one();
+    }
+}
+
+auto task_pool::run_pending() -> bool
+{
+    auto const own = this->own_queue();
+    auto const num_queues = m_queues.size();
+    task t;
+
+    // newest own task first, it works on data that is still in cache, then the oldest (largest) of the others
+    bool found = this->try_pop(own, true, t);
+
+    for(std::size_t k = 1; !found && k < num_queues; ++k) {
+        found = this->try_pop((own + k) % num_queues, false, t);
+    }
+
+    if(found) {
+        t();
+    }
+
+    return found;
+}
+
+auto task_pool::run_until_zero(std::atomic<std::size_t> const& count) -> void
+{
+    while(count.load(std::memory_order_acquire) > 0) {
+        if(this->run_pending()) {
+            continue;
+        }
+
+        // Same handshake as between `submit` and sleeping workers: either `notify_waiters` sees this thread waiting
+        // or this thread sees the count at zero, and `submit` wakes it for new tasks.
+        std::unique_lock<std::mutex> lock{ m_sleep_lock };
+        m_waiting.fetch_add(1, std::memory_order_seq_cst);
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+
+        m_wake.wait(lock, [this, &count] {
+            return count.load(std::memory_order_seq_cst) == 0 || m_pending.load(std::memory_order_seq_cst) > 0;
+        });
+
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        m_waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+auto task_pool::notify_waiters() -> void
+{
+    if(m_waiting.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard{ m_sleep_lock };
+    }
+
+    m_wake.notify_all();
+}
+
+auto task_pool::worker_loop(std::size_t const id) -> void
+{
+    t_pool = this;
+    t_queue = id;
+
+    while(!m_stop.load(std::memory_order_relaxed)) {
+        if(this->run_pending()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{ m_sleep_lock };
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+
+        m_wake.wait(lock, [this] {
+            return m_stop.load(std::memory_order_relaxed) || m_pending.load(std::memory_order_seq_cst) > 0;
+        });
+
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+task_group::task_group(task_pool& pool) noexcept
+    : m_pool{ pool }
+{
+}
+
+task_group::~task_group() noexcept
+{
+    ASSERT(m_pending.load(std::memory_order_relaxed) == 0);
+}
+
+auto task_group::finish() noexcept -> void
+{
+    // the group may be gone as soon as the count hits zero
+    auto& pool = m_pool;
+
+    if(m_pending.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        pool.notify_waiters();
+    }
+}
+
+auto task_group::fail(std::exception_ptr error) noexcept -> void
+{
+    std::lock_guard<std::mutex> guard{ m_error_lock };
+
+    if(!m_error) {
+        m_error = std::move(error);
+    }
+}
+
+auto task_group::wait() -> void
+{
+    m_pool.run_until_zero(m_pending);
+
+    std::exception_ptr error{};
+
+    {
+        std::lock_guard<std::mutex> guard{ m_error_lock };
+        error = std::exchange(m_error, nullptr);
+    }
+
+    if(error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace core
@@ -0,0 +1,149 @@
+#ifndef SORTVIS_TASK_POOL_HPP
+#define SORTVIS_TASK_POOL_HPP
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+// Work-stealing thread pool for fork-join algorithms.
+// Every worker owns a deque: it pushes and pops its own tasks at the back and steals from the front of the others'
+// when it runs out. Threads outside the pool submit to one extra shared deque. A thread waiting on a `task_group`
+// runs pending tasks instead of blocking, so nested fork-join never starves the pool, and only sleeps once there are
+// none left to run.
+class task_pool
+{
+public:
+    using task = std::function<void()>;
+
+private:
+    struct task_queue
+    {
+        std::mutex lock{};
+        std::deque<task> tasks{};
+    };
+
+    // the last queue is shared by every thread outside the pool
+    std::vector<std::unique_ptr<task_queue>> m_queues{};
+    std::vector<std::thread> m_workers{};
+
+    std::atomic<std::size_t> m_pending{ 0 };
+    std::atomic<std::size_t> m_sleeping{ 0 };
+    std::atomic<std::size_t> m_waiting{ 0 }; // threads sleeping in `run_until_zero`
+    std::atomic<bool> m_stop{ false };
+    std::mutex m_sleep_lock{};
+    std::condition_variable m_wake{};
+
+    // Index of the calling thread's queue.
+    [[nodiscard]] auto own_queue() const noexcept -> std::size_t;
+    [[nodiscard]] auto try_pop(std::size_t queue, bool from_back, task& out) -> bool;
+    auto worker_loop(std::size_t id) -> void;
+
+public:
+    task_pool() = delete;
+    task_pool(task_pool const&) = delete;
+    task_pool(task_pool&&) = delete;
+    ~task_pool() noexcept;
+
+    explicit task_pool(std::size_t num_workers);
+
+    auto operator=(task_pool const&) -> task_pool& = delete;
+    auto operator=(task_pool&&) -> task_pool& = delete;
+
+    // The pool parallel algorithms use: the one given to `set_instance`, otherwise a default one with a worker per
+    // hardware thread besides the calling one.
+    [[nodiscard]] static auto instance() -> task_pool&;
+    // `nullptr` goes back to the default pool. Only switch pools while no algorithm is running.
+    static auto set_instance(task_pool* pool) noexcept -> void;
+
+    [[nodiscard]] auto num_workers() const noexcept -> std::size_t;
+    // Threads that work on the pool's tasks, counting the one waiting for them.
+    [[nodiscard]] auto concurrency() const noexcept -> std::size_t;
+
+    auto submit(task t) -> void;
+    // Runs one pending task, preferring the calling thread's own, returns false if there was none.
+    auto run_pending() -> bool;
+    // Runs pending tasks until `count` drops to zero, sleeping while there are none. Whoever takes `count` to zero
+    // has to call `notify_waiters()`.
+    auto run_until_zero(std::atomic<std::size_t> const& count) -> void;
+    auto notify_waiters() -> void;
+};
+
+// Tracks a set of tasks so they can be waited on together.
+class task_group
+{
+private:
+    task_pool& m_pool;
+    std::atomic<std::size_t> m_pending{ 0 };
+    std::mutex m_error_lock{};
+    std::exception_ptr m_error{};
+
+    // Counts a task as finished however it left `f()`.
+    struct finish_guard
+    {
+        task_group& group;
+
+        explicit finish_guard(task_group& g) noexcept
+            : group{ g }
+        {
+        }
+        finish_guard(finish_guard const&) = delete;
+        finish_guard(finish_guard&&) = delete;
+        ~finish_guard() noexcept
+        {
+            group.finish();
+        }
+
+        auto operator=(finish_guard const&) -> finish_guard& = delete;
+        auto operator=(finish_guard&&) -> finish_guard& = delete;
+    };
+
+    auto finish() noexcept -> void;
+    // Keeps the first exception a task threw for `wait()` to rethrow.
+    auto fail(std::exception_ptr error) noexcept -> void;
+
+public:
+    task_group() = delete;
+    task_group(task_group const&) = delete;
+    task_group(task_group&&) = delete;
+    ~task_group() noexcept;
+
+    explicit task_group(task_pool& pool) noexcept;
+
+    auto operator=(task_group const&) -> task_group& = delete;
+    auto operator=(task_group&&) -> task_group& = delete;
+
+    template<typename F>
+    auto run(F&& func) -> void
+    {
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        m_pool.submit([this, f = std::forward<F>(func)]() mutable {
+            finish_guard const guard{ *this };
+
+            try {
+                f();
+            }
+            catch(...) {
+                this->fail(std::current_exception());
+            }
+        });
+    }
+
+    // Helps running the pool's tasks until every task of the group finished, then rethrows the first exception one
+    // of them threw.
+    auto wait() -> void;
+};
+
+} // namespace core
+
+#endif // !SORTVIS_TASK_POOL_HPP
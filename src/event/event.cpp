@@ -2,264 +2,699 @@
 #include "log/log.hpp"
 
 #include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <mutex>
 #include <utility>
 
 namespace core {
 
-event_manager::event_manager()
+namespace {
+
+// A block starts with a header word: the sequence number in the upper bits, the number of event words after it in
+// the lower `g_block_size_bits`.
+constexpr unsigned g_block_size_bits = 16;
+
+[[nodiscard]] constexpr auto make_block_header(std::uint64_t const sequence, std::size_t const words) noexcept
+    -> packed_event
 {
-    m_events.emplace_back();
+    return (sequence << g_block_size_bits) | words;
 }
 
+[[nodiscard]] constexpr auto block_sequence(packed_event const header) noexcept -> std::uint64_t
+{
+    return header >> g_block_size_bits;
+}
+
+[[nodiscard]] constexpr auto block_size(packed_event const header) noexcept -> std::size_t
+{
+    return header & ((std::uint64_t{ 1 } << g_block_size_bits) - 1);
+}
+
+} // namespace
+
 auto event_manager::instance() -> event_manager&
 {
     static event_manager mng;
     return mng;
 }
 
+event_manager::~event_manager() noexcept
+{
+    auto* l = m_lanes.load(std::memory_order_acquire);
+
+    while(l != nullptr) {
+        auto* const next = l->next;
+        delete l; // NOLINT
+        l = next;
+    }
+}
+
+event_manager::lane::lane()
+    : back{ new segment{} } // NOLINT
+    , front{ back }
+{
+}
+
+event_manager::lane::~lane() noexcept
+{
+    while(front != nullptr) {
+        delete std::exchange(front, front->next.load(std::memory_order_relaxed)); // NOLINT
+    }
+
+    delete spare.load(std::memory_order_relaxed); // NOLINT
+}
+
+auto event_manager::lane::reserve(std::size_t const count) -> void
+{
+    if(back->words.can_push(count)) {
+        return;
+    }
+
+    auto* added = spare.exchange(nullptr, std::memory_order_acquire);
+
+    if(added == nullptr) {
+        added = new segment{}; // NOLINT
+    }
+
+    // This thread is done with the full segment, so the consumer may move past it before anything is pushed.
+    back->next.store(added, std::memory_order_release);
+    back = added;
+}
+
+auto event_manager::lane::push(packed_event const* const words, std::size_t const count) noexcept -> void
+{
+    [[maybe_unused]] auto const pushed = back->words.try_push_all(words, count);
+    ASSERT(pushed);
+}
+
+auto event_manager::lane::try_pop(packed_event* const out, std::size_t const max_count) noexcept -> std::size_t
+{
+    // popping nothing would look like a drained segment
+    if(max_count == 0) {
+        return 0;
+    }
+
+    while(true) {
+        if(auto const popped = front->words.try_pop(out, max_count); popped > 0) {
+            return popped;
+        }
+
+        auto* const following = front->next.load(std::memory_order_acquire);
+
+        if(following == nullptr) {
+            return 0;
+        }
+
+        // The producer filled this segment before linking the next one, so a last look catches its final block.
+        if(auto const popped = front->words.try_pop(out, max_count); popped > 0) {
+            return popped;
+        }
+
+        auto* const drained = std::exchange(front, following);
+        drained->next.store(nullptr, std::memory_order_relaxed);
+        delete spare.exchange(drained, std::memory_order_acq_rel); // NOLINT
+    }
+}
+
+event_manager::producer::~producer() noexcept
+{
+    auto& mng = event_manager::instance();
+    exiting = true;
+
+    try {
+        // no event follows the accesses still held back anymore
+        for(std::size_t k = 0; k < held.count; ++k) {
+            mng.append(*this, held.events.at(k));
+        }
+
+        held.count = 0;
+        mng.publish(*this);
+    }
+    catch(...) {
+        // a thread can't report anything while exiting, its last events are lost
+    }
+
+    if(owned_lane != nullptr) {
+        owned_lane->owned.store(false, std::memory_order_release);
+    }
+}
+
+auto event_manager::local_producer() -> producer&
+{
+    thread_local producer p;
+    return p;
+}
+
+auto event_manager::held_back() -> held_accesses&
+{
+    return local_producer().held;
+}
+
+auto event_manager::acquire_lane() -> lane*
+{
+    // reuse the lane of a thread that already exited, so short-lived threads don't pile up rings
+    for(auto* l = m_lanes.load(std::memory_order_acquire); l != nullptr; l = l->next) {
+        bool expected = false;
+
+        if(l->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return l;
+        }
+    }
+
+    auto* const l = new lane{}; // NOLINT
+    l->id = m_num_lanes.fetch_add(1, std::memory_order_relaxed);
+    l->next = m_lanes.load(std::memory_order_relaxed);
+
+    while(!m_lanes.compare_exchange_weak(l->next, l, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    return l;
+}
+
 auto event_manager::push(event_data const& event) -> void
 {
-    {
-        std::scoped_lock<std::mutex> lock{ m_events.back().second };
+    this->append(local_producer(), event);
+}
+
+auto event_manager::append(producer& p, event_data const& event) -> void
+{
+    if(p.count + max_packed_event_size > s_block_words) {
+        this->publish(p);
+    }
+
+    p.count += pack(event, &p.block.at(p.count));
+}
 
-        if(m_events.back().first.size() == s_max_events_per_block) {
-            m_events.emplace_back();
+auto event_manager::push(event_data const* const events, std::size_t const count) -> void
+{
+    for(std::size_t k = 0; k < count; ++k) {
+        this->push(events[k]); // NOLINT
+    }
+}
+
+auto event_manager::push_packed(packed_event const* words, std::size_t count) -> void
+{
+    auto& p = local_producer();
+
+    while(count > 0) {
+        auto const size = packed_size(*words);
+
+        if(p.count + size > s_block_words) {
+            this->publish(p);
         }
+
+        std::copy(words, words + size, &p.block.at(p.count)); // NOLINT
+        p.count += size;
+        words += size; // NOLINT
+        count -= size;
     }
+}
 
-    std::scoped_lock<std::mutex> lock{ m_events.back().second };
-    auto& events = m_events.back().first;
-    events.push_back(event);
+auto event_manager::flush() -> void
+{
+    this->publish(local_producer());
+}
+
+auto event_manager::publish(producer& p) -> void
+{
+    auto const words = p.count;
+
+    if(words == 1) {
+        return;
+    }
+
+    p.count = 1;
+
+    if(!p.exiting && m_queued.load(std::memory_order_relaxed) + words > m_high_water.load(std::memory_order_relaxed)) {
+        this->wait_for_room();
+    }
+    if(this->closed()) {
+        return;
+    }
+    if(p.owned_lane == nullptr) {
+        p.owned_lane = this->acquire_lane();
+    }
+
+    // A sequence number no block carries would stall the consumer for good, so anything that can throw comes first.
+    p.owned_lane->reserve(words);
+    p.block[0] = make_block_header(m_next_sequence.fetch_add(1, std::memory_order_relaxed), words - 1);
+    // counted before it is visible, so `m_queued` never drops below what the lanes hold
+    m_queued.fetch_add(words, std::memory_order_relaxed);
+    p.owned_lane->push(p.block.data(), words);
 }
 
 auto event_manager::pop() -> event_data
 {
-    {
-        std::scoped_lock<std::mutex> lock{ m_events.front().second };
+    event_data result{};
+    [[maybe_unused]] auto const popped = this->pop(&result, 1);
+    ASSERT(popped == 1);
+    return result;
+}
+
+auto event_manager::pop(event_data* const out, std::size_t const max_count) noexcept -> std::size_t
+{
+    std::array<packed_event, s_pop_batch + max_packed_event_size - 1> words{};
+    std::size_t decoded = 0;
+
+    while(decoded < max_count) {
+        // `read_block` leaves room to finish the last event, so this never decodes more than `max_count` events
+        auto const wanted = std::min(max_count - decoded, s_pop_batch) + max_packed_event_size - 1;
+        std::uint32_t lane_id = 0;
+        auto const available = this->read_block(words.data(), wanted, lane_id);
 
-        if(m_events.front().first.empty()) {
-            m_events.pop_front();
+        if(available == 0) {
+            break;
+        }
+
+        for(std::size_t k = 0; k < available; ++decoded) {
+            k += unpack(&words.at(k), out[decoded]); // NOLINT
+            out[decoded].lane = lane_id;             // NOLINT
         }
     }
 
-    std::scoped_lock<std::mutex> lock{ m_events.front().second };
-    auto const [type, i, j] = m_events.front().first.front();
-    m_events.front().first.pop_front();
-    return { type, i, j };
+    this->release_consumed();
+    return decoded;
 }
 
-auto event_manager::empty() noexcept -> bool
+auto event_manager::pop_packed(packed_event* const out, std::size_t const max_count) noexcept -> std::size_t
 {
-    for(auto& event : m_events) {
-        std::scoped_lock<std::mutex> lock{ event.second };
+    ASSERT(max_count >= max_packed_event_size);
+
+    std::size_t popped = 0;
+
+    while(max_count - popped >= max_packed_event_size) {
+        std::uint32_t lane_id = 0;
+        auto const available = this->read_block(out + popped, max_count - popped, lane_id); // NOLINT
 
-        if(!event.first.empty()) {
-            return false;
+        if(available == 0) {
+            break;
         }
+
+        popped += available;
     }
 
-    return true;
+    this->release_consumed();
+    return popped;
 }
 
-auto operator==(event_data const& a, event_data const& b) noexcept -> bool
+auto event_manager::next_block() noexcept -> bool
 {
-    return a.type == b.type && a.i == b.i && a.j == b.j;
+    for(auto* l = m_lanes.load(std::memory_order_acquire); l != nullptr; l = l->next) {
+        if(!l->has_header) {
+            l->has_header = l->try_pop(&l->header, 1) == 1;
+        }
+        if(l->has_header && block_sequence(l->header) == m_expected_sequence) {
+            m_reading = l;
+            m_block_left = block_size(l->header);
+            l->has_header = false;
+            ++m_expected_sequence;
+            ++m_consumed;
+            return true;
+        }
+    }
+
+    // the next block is either not handed over yet or still on its way into its lane
+    return false;
 }
 
-auto operator!=(event_data const& a, event_data const& b) noexcept -> bool
+auto event_manager::read_block(packed_event* const out, std::size_t const max_count, std::uint32_t& lane_id) noexcept
+    -> std::size_t
 {
-    return !(a == b);
+    ASSERT(max_count >= max_packed_event_size);
+
+    if(m_reading == nullptr && !this->next_block()) {
+        return 0;
+    }
+
+    auto available = m_reading->try_pop(out, std::min(m_block_left, max_count - (max_packed_event_size - 1)));
+    std::size_t k = 0;
+
+    while(k < available) {
+        k += packed_size(out[k]); // NOLINT
+    }
+
+    if(k > available) {
+        // the whole block was published at once, so the rest of the event is already there
+        available += m_reading->try_pop(out + available, k - available); // NOLINT
+    }
+
+    lane_id = m_reading->id;
+    m_block_left -= available;
+    m_consumed += available;
+
+    if(m_block_left == 0) {
+        m_reading = nullptr;
+    }
+
+    return available;
 }
 
-auto normal_emitter::on_access(element_t const i, element_t const val) -> void
+auto event_manager::release_consumed() noexcept -> void
 {
-    TRACE("[Worker] Accessed at index {}", i);
-    event_manager::instance().push({ event_type::access, i, val });
+    if(m_consumed == 0) {
+        return;
+    }
+
+    m_queued.fetch_sub(m_consumed, std::memory_order_seq_cst);
+    m_consumed = 0;
+    this->notify_room();
 }
 
-auto normal_emitter::on_swap(element_t const i, element_t const j) -> void
+auto event_manager::wait_for_room() -> void
 {
-    TRACE("[Worker] Swapped at index ({}, {})", i, j);
-    event_manager::instance().push({ event_type::swap, i, j });
+    std::unique_lock<std::mutex> lock{ m_wait_lock };
+
+    // Pairs with the fence in `notify_room`: either the consumer sees the count or this sees the consumer's pops.
+    m_producers_waiting.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    m_room.wait(lock, [this] {
+        return this->closed() ||
+               m_queued.load(std::memory_order_relaxed) <= m_low_water.load(std::memory_order_relaxed);
+    });
+
+    m_producers_waiting.fetch_sub(1, std::memory_order_relaxed);
 }
 
-auto normal_emitter::on_modify(element_t const i, element_t const value) -> void
+auto event_manager::notify_room() noexcept -> void
 {
-    TRACE("[Worker] Modified at index {} with value {}", i, value);
-    event_manager::instance().push({ event_type::modify, i, value });
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(m_producers_waiting.load(std::memory_order_relaxed) == 0 ||
+       m_queued.load(std::memory_order_relaxed) > m_low_water.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // taking the lock makes sure every producer is either still checking or already waiting
+    std::lock_guard<std::mutex> guard{ m_wait_lock };
+    m_room.notify_all();
 }
 
-auto normal_emitter::on_comparison(element_t const i, element_t const j) -> void
+auto event_manager::empty() const noexcept -> bool
 {
-    TRACE("[Worker] Compared at index ({}, {})", i, j);
-    event_manager::instance().push({ event_type::compare, i, j });
+    return this->size() == 0;
 }
 
-auto normal_emitter::on_end() -> void
+auto event_manager::size() const noexcept -> std::size_t
 {
-    TRACE("[Worker] Ended sorting");
-    event_manager::instance().push({ event_type::end, 0, 0 });
+    return m_queued.load(std::memory_order_acquire);
 }
 
-auto test_emitter::on_access(element_t const, element_t const) -> void
+auto event_manager::set_max_queued(std::size_t const words) noexcept -> void
 {
+    // a waiting producer resumes at half the mark, a whole block has to fit on top of that
+    auto const high = std::clamp<std::size_t>(words, 2 * s_block_words, s_capacity);
+
+    m_high_water.store(high, std::memory_order_relaxed);
+    m_low_water.store(high / 2, std::memory_order_relaxed);
 }
 
-auto test_emitter::on_swap(element_t const, element_t const) -> void
+auto event_manager::max_queued() const noexcept -> std::size_t
 {
+    return m_high_water.load(std::memory_order_relaxed);
 }
 
-auto test_emitter::on_modify(element_t const, element_t const) -> void
+auto event_manager::close() noexcept -> void
 {
+    m_closed.store(true, std::memory_order_release);
+
+    std::lock_guard<std::mutex> guard{ m_wait_lock };
+    m_room.notify_all();
 }
 
-auto test_emitter::on_comparison(element_t const, element_t const) -> void
+auto event_manager::closed() const noexcept -> bool
 {
+    return m_closed.load(std::memory_order_acquire);
 }
 
-auto test_emitter::on_end() -> void
+auto operator==(event_data const& a, event_data const& b) noexcept -> bool
 {
+    return a.type == b.type && a.i == b.i && a.j == b.j;
 }
 
-array_value::array_value(element_t const init)
-    : m_value{ init }
-    , m_index{ 0 }
+auto operator!=(event_data const& a, event_data const& b) noexcept -> bool
 {
+    return !(a == b);
 }
 
-auto array_value::operator=(element_t const val) noexcept -> array_value&
+namespace {
+
+enum class packed_form : std::uint64_t
 {
-    m_value = val;
-    return *this;
+    absolute,
+    delta,
+    extended
+};
+
+constexpr std::uint64_t g_type_bits = 3;
+constexpr std::uint64_t g_form_bits = 2;
+constexpr std::uint64_t g_header_bits = g_type_bits + g_form_bits;
+
+constexpr std::uint64_t g_absolute_i_bits = 29;
+constexpr std::uint64_t g_absolute_j_bits = 64 - g_header_bits - g_absolute_i_bits;
+
+constexpr std::uint64_t g_delta_i_bits = 45;
+constexpr std::uint64_t g_delta_bits = 64 - g_header_bits - g_delta_i_bits;
+constexpr std::int64_t g_max_delta = (std::int64_t{ 1 } << (g_delta_bits - 1)) - 1;
+constexpr std::int64_t g_min_delta = -g_max_delta - 1;
+
+[[nodiscard]] constexpr auto mask(std::uint64_t const bits) noexcept -> std::uint64_t
+{
+    return (std::uint64_t{ 1 } << bits) - 1;
 }
 
-auto array_value::set_index(element_t const index) const noexcept -> void
+[[nodiscard]] constexpr auto header(event_type const type, packed_form const form) noexcept -> packed_event
 {
-    m_index = index;
+    return static_cast<std::uint64_t>(type) | (static_cast<std::uint64_t>(form) << g_type_bits);
 }
 
-auto array_value::get() const noexcept -> element_t
+[[nodiscard]] constexpr auto form_of(packed_event const word) noexcept -> packed_form
 {
-    emitter_t::on_access(m_index, m_value);
-    return m_value;
+    return static_cast<packed_form>((word >> g_type_bits) & mask(g_form_bits));
 }
 
-auto array_value::get_raw() const noexcept -> element_t
+} // namespace
+
+auto pack(event_data const& event, packed_event* const out) noexcept -> std::size_t
 {
-    return m_value;
+    std::uint64_t const i = event.i;
+    std::uint64_t const j = event.j;
+
+    if(i <= mask(g_absolute_i_bits) && j <= mask(g_absolute_j_bits)) {
+        out[0] = header(event.type, packed_form::absolute) | (i << g_header_bits) | // NOLINT
+                 (j << (g_header_bits + g_absolute_i_bits));
+        return 1;
+    }
+
+    auto const delta = static_cast<std::int64_t>(j - i);
+
+    if(i <= mask(g_delta_i_bits) && delta >= g_min_delta && delta <= g_max_delta) {
+        auto const delta_bits = static_cast<std::uint64_t>(delta) & mask(g_delta_bits);
+        out[0] = header(event.type, packed_form::delta) | (i << g_header_bits) | // NOLINT
+                 (delta_bits << (g_header_bits + g_delta_i_bits));
+        return 1;
+    }
+
+    out[0] = header(event.type, packed_form::extended); // NOLINT
+    out[1] = i;                                         // NOLINT
+    out[2] = j;                                         // NOLINT
+    return max_packed_event_size;
 }
 
-auto array_value::index() const noexcept -> element_t
+auto packed_size(packed_event const header) noexcept -> std::size_t
 {
-    return m_index;
+    return (form_of(header) == packed_form::extended) ? max_packed_event_size : 1;
 }
 
-#define OPERATOR(op)                                                                                                   \
-    auto operator op(array_value const& a, array_value const& b) noexcept->bool                                        \
-    {                                                                                                                  \
-        emitter_t::on_comparison(a.index(), b.index());                                                                \
-        return a.get_raw() op b.get_raw();                                                                             \
+auto unpack(packed_event const* const in, event_data& event) noexcept -> std::size_t
+{
+    auto const word = in[0]; // NOLINT
+    event.type = static_cast<event_type>(word & mask(g_type_bits));
+
+    switch(form_of(word)) {
+    case packed_form::absolute: {
+        event.i = (word >> g_header_bits) & mask(g_absolute_i_bits);
+        event.j = word >> (g_header_bits + g_absolute_i_bits);
+        return 1;
+    }
+    case packed_form::delta: {
+        auto const i = (word >> g_header_bits) & mask(g_delta_i_bits);
+        // sign-extend the delta by shifting it to the top of a signed word and back
+        auto const delta = static_cast<std::int64_t>(word) >> (g_header_bits + g_delta_i_bits);
+        event.i = i;
+        event.j = i + static_cast<std::uint64_t>(delta);
+        return 1;
+    }
+    default: {
+        event.i = in[1]; // NOLINT
+        event.j = in[2]; // NOLINT
+        return max_packed_event_size;
     }
+    }
+}
 
-OPERATOR(==)
-OPERATOR(!=)
-OPERATOR(<)
-OPERATOR(<=)
-OPERATOR(>=)
-OPERATOR(>)
+namespace {
 
-#undef OPERATOR
+std::atomic<bool> g_coalescing{ true };
 
-array::array(std::vector<element_t> const& input)
+constexpr element_t g_no_index = std::numeric_limits<element_t>::max();
+
+// Pushes the held back accesses to anything but `i` and `j`, followed by `event`.
+auto push_coalesced(event_data const& event, element_t const i, element_t const j) -> void
 {
-    m_data.reserve(input.size());
+    auto& held = event_manager::held_back();
+    std::array<event_data, event_manager::held_accesses::capacity + 1> out{};
+    std::size_t count = 0;
+
+    for(std::size_t k = 0; k < held.count; ++k) {
+        auto const& access = held.events.at(k);
 
-    for(element_t const val : input) {
-        m_data.emplace_back(val);
+        if(access.i != i && access.i != j) {
+            out.at(count++) = access;
+        }
     }
+
+    held.count = 0;
+    out.at(count++) = event;
+    event_manager::instance().push(out.data(), count);
 }
 
-auto array::swap_at(element_t const i, element_t const j) -> void
+} // namespace
+
+auto normal_emitter::on_access(element_t const i, element_t const val) -> void
 {
-    emitter_t::on_swap(i, j);
-    std::swap(m_data[i], m_data[j]);
+    TRACE("[Worker] Accessed at index {}", i);
+
+    if(!normal_emitter::coalescing()) {
+        event_manager::instance().push({ event_type::access, i, val });
+        return;
+    }
+
+    auto& pending = event_manager::held_back();
+
+    // `data[i].get()` reads the same element twice in a row
+    if(pending.count > 0 && pending.events.at(pending.count - 1).i == i) {
+        pending.events.at(pending.count - 1).j = val;
+        return;
+    }
+    if(pending.count == pending.events.size()) {
+        event_manager::instance().push(pending.events.data(), pending.count);
+        pending.count = 0;
+    }
+
+    pending.events.at(pending.count++) = { event_type::access, i, val };
 }
 
-auto array::swap_at(int const i, int const j) -> void
+auto normal_emitter::on_swap(element_t const i, element_t const j) -> void
 {
-    ASSERT(i >= 0);
-    ASSERT(j >= 0);
-
-    this->swap_at(static_cast<element_t>(i), static_cast<element_t>(j));
+    TRACE("[Worker] Swapped at index ({}, {})", i, j);
+    push_coalesced({ event_type::swap, i, j }, i, j);
 }
 
-auto array::modify(element_t const i, element_t const val) const -> void
+auto normal_emitter::on_modify(element_t const i, element_t const value) -> void
 {
-    emitter_t::on_modify(i, val);
-    static_cast<void>(m_data); // ignore 'methd can be made static'
+    TRACE("[Worker] Modified at index {} with value {}", i, value);
+    push_coalesced({ event_type::modify, i, value }, i, i);
 }
 
-auto array::modify(int const i, int const val) const -> void
+auto normal_emitter::on_comparison(element_t const i, element_t const j) -> void
 {
-    ASSERT(i >= 0);
+    TRACE("[Worker] Compared at index ({}, {})", i, j);
+    push_coalesced({ event_type::compare, i, j }, i, j);
+}
 
-    this->modify(static_cast<element_t>(i), static_cast<element_t>(val));
+auto normal_emitter::on_end() -> void
+{
+    TRACE("[Worker] Ended sorting");
+    push_coalesced({ event_type::end, 0, 0 }, g_no_index, g_no_index);
+    event_manager::instance().flush();
 }
 
-auto array::end() -> void
+auto normal_emitter::set_coalescing(bool const enabled) noexcept -> void
 {
-    emitter_t::on_end();
-    static_cast<void>(m_data); // ignore 'method can be made static'
+    g_coalescing.store(enabled, std::memory_order_relaxed);
 }
 
-auto array::operator[](element_t const index) noexcept -> array_value&
+auto normal_emitter::coalescing() noexcept -> bool
 {
-    emitter_t::on_access(index, m_data[index].get_raw());
-    auto& val = m_data[index];
-    val.set_index(index);
-    return val;
+    return g_coalescing.load(std::memory_order_relaxed);
 }
 
-auto array::operator[](element_t const index) const noexcept -> array_value const&
+auto normal_emitter::flush() -> void
 {
-    emitter_t::on_access(index, m_data[index].get_raw());
-    auto const& val = m_data[index];
-    val.set_index(index);
-    return val;
+    auto& mng = event_manager::instance();
+    auto& held = event_manager::held_back();
+
+    mng.push(held.events.data(), held.count);
+    held.count = 0;
+    mng.flush();
 }
 
-auto array::operator[](int const index) noexcept -> array_value&
+auto operator==(operation_counts const& a, operation_counts const& b) noexcept -> bool
 {
-    ASSERT(index >= 0);
-    return this->operator[](static_cast<element_t>(index));
+    return a.accesses == b.accesses && a.comparisons == b.comparisons && a.swaps == b.swaps &&
+           a.modifies == b.modifies;
 }
 
-auto array::operator[](int const index) const noexcept -> array_value const&
+auto operator!=(operation_counts const& a, operation_counts const& b) noexcept -> bool
 {
-    ASSERT(index >= 0);
-    return this->operator[](static_cast<element_t>(index));
+    return !(a == b);
 }
 
-auto array::size() const noexcept -> std::size_t
+namespace {
+
+struct stats_registry
+{
+    std::mutex lock;
+    // a deque never moves its elements, so the references handed out to threads stay valid
+    std::deque<stats_emitter::counters> threads;
+};
+
+auto registry() -> stats_registry&
 {
-    return m_data.size();
+    static stats_registry instance;
+    return instance;
 }
 
-auto array::isize() const noexcept -> int
+} // namespace
+
+auto stats_emitter::register_thread() -> counters&
 {
-    return static_cast<int>(m_data.size());
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard{ reg.lock };
+    return reg.threads.emplace_back();
 }
 
-auto array::is_sorted() const noexcept -> bool
+auto stats_emitter::counts() -> operation_counts
 {
-    std::vector<element_t> data;
-    data.reserve(m_data.size());
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard{ reg.lock };
+    operation_counts result{};
 
-    for(auto const& val : m_data) {
-        data.push_back(val.get_raw());
+    for(auto const& c : reg.threads) {
+        result.accesses += c.accesses.load(std::memory_order_relaxed);
+        result.comparisons += c.comparisons.load(std::memory_order_relaxed);
+        result.swaps += c.swaps.load(std::memory_order_relaxed);
+        result.modifies += c.modifies.load(std::memory_order_relaxed);
     }
 
-    return std::is_sorted(data.begin(), data.end());
+    return result;
+}
+
+// Only meant to be called while no sort is counting, a concurrent increment may survive the reset.
+auto stats_emitter::reset() -> void
+{
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard{ reg.lock };
+
+    for(auto& c : reg.threads) {
+        c.accesses.store(0, std::memory_order_relaxed);
+        c.comparisons.store(0, std::memory_order_relaxed);
+        c.swaps.store(0, std::memory_order_relaxed);
+        c.modifies.store(0, std::memory_order_relaxed);
+    }
 }
 
 } // namespace core
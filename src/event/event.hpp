@@ -2,13 +2,28 @@
 #define SORTVIS_EVENT_HPP
 #pragma once
 
+#include "key.hpp"
+#include "spsc_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
 #include <cstddef>
-#include <deque>
-#include <list>
+#include <cstdint>
 #include <mutex>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+// log.hpp's macros would clash with doctest's in every test including this header, so it checks with `assert`.
+#ifdef SORTVIS_DEBUG
+#define SORTVIS_ASSERT(...) assert(__VA_ARGS__)
+#else
+#define SORTVIS_ASSERT(...) static_cast<void>(0)
+#endif
+
 namespace core {
 
 using element_t = std::size_t;
@@ -27,34 +42,197 @@ struct event_data
     event_type type{ event_type::access };
     element_t i{ 0 };
     element_t j{ 0 };
+    // Which producer lane (one per pushing thread) the event arrived through, only filled in by
+    // `event_manager::pop`. It is not part of the event, `==` ignores it.
+    std::uint32_t lane{ 0 };
 };
 
 [[nodiscard]] auto operator==(event_data const& a, event_data const& b) noexcept -> bool;
 [[nodiscard]] auto operator!=(event_data const& a, event_data const& b) noexcept -> bool;
 
+// Wire format of an event in the queue (and in traces):
+//   bits [0, 3)  event type
+//   bits [3, 5)  operand form
+//     absolute: i in bits [5, 34), j in bits [34, 64)
+//     delta:    i in bits [5, 50), (j - i) as a signed 14 bit number in bits [50, 64)
+//     extended: i and j follow as two raw words
+// so anything short of a billion elements costs one word instead of `sizeof(event_data)`.
+using packed_event = std::uint64_t;
+
+inline constexpr std::size_t max_packed_event_size = 3;
+
+// Writes `event` to `out`, which must have room for `max_packed_event_size` words, returns how many were used.
+auto pack(event_data const& event, packed_event* out) noexcept -> std::size_t;
+// How many words the event whose first word is `header` takes.
+[[nodiscard]] auto packed_size(packed_event header) noexcept -> std::size_t;
+// Reads one event from `in`, returns how many words were consumed.
+auto unpack(packed_event const* in, event_data& event) noexcept -> std::size_t;
+
+// Events travel in blocks: every producer thread packs its events into a private block and hands it over once full
+// (or on `flush()`, or when the thread exits). Each block is stamped from a global sequence counter and queued on
+// a lane, a chain of SPSC rings owned by that thread, so producers never contend on anything but the counter. The
+// consumer reads blocks in sequence order across all lanes, which rebuilds the order in which blocks were handed over.
 class event_manager
 {
-    using locked_vector = std::pair<std::deque<event_data>, std::mutex>;
-    static constexpr int s_max_events_per_block = 32;
+    static constexpr std::size_t s_capacity = 1U << 18U;
+    static constexpr std::size_t s_pop_batch = 256;
+    // words per block including its header, small enough to keep playback smooth when a block is handed over
+    static constexpr std::size_t s_block_words = 256;
+    // words per lane segment, a lane only grows past one while its thread runs ahead of the consumer
+    static constexpr std::size_t s_segment_words = 16 * s_block_words;
+
+    struct segment
+    {
+        spsc_queue<packed_event> words{ s_segment_words };
+        // linked by the producer once it's done with this segment
+        std::atomic<segment*> next{ nullptr };
+    };
+
+    // Blocks are pushed whole, so a block never spans two segments.
+    struct lane
+    {
+        lane* next{ nullptr };
+        std::atomic<bool> owned{ true };
+        std::uint32_t id{ 0 };
+
+        segment* back{ nullptr };                   // producer side
+        segment* front{ nullptr };                  // consumer side
+        std::atomic<segment*> spare{ nullptr };     // a drained segment, handed back for the producer to reuse
+
+        // consumer side, the header of the lane's next block once it has been popped
+        packed_event header{ 0 };
+        bool has_header{ false };
+
+        lane();
+        lane(lane const&) = delete;
+        lane(lane&&) = delete;
+        ~lane() noexcept;
+
+        auto operator=(lane const&) -> lane& = delete;
+        auto operator=(lane&&) -> lane& = delete;
+
+        // Producer side, links another segment when `count` words don't fit in the last one.
+        auto reserve(std::size_t count) -> void;
+        // Producer side, `count` must have been reserved.
+        auto push(packed_event const* words, std::size_t count) noexcept -> void;
+        // Consumer side.
+        [[nodiscard]] auto try_pop(packed_event* out, std::size_t max_count) noexcept -> std::size_t;
+    };
+
+public:
+    // Accesses the normal emitter holds back to coalesce them, either dropped or pushed before the next event.
+    struct held_accesses
+    {
+        static constexpr std::size_t capacity = 4;
+
+        std::array<event_data, capacity> events{};
+        std::size_t count{ 0 };
+    };
 
 private:
-    std::list<locked_vector> m_events;
+    // The calling thread's block and lane.
+    struct producer
+    {
+        std::array<packed_event, s_block_words> block{};
+        std::size_t count{ 1 }; // block[0] is left for the header
+        lane* owned_lane{ nullptr };
+        // pushed ahead of the last block when the thread exits
+        held_accesses held{};
+        // set while the thread exits, its last blocks are handed over without waiting for a consumer that may be gone
+        bool exiting{ false };
+
+        producer() noexcept = default;
+        producer(producer const&) = delete;
+        producer(producer&&) = delete;
+        ~producer() noexcept;
+
+        auto operator=(producer const&) -> producer& = delete;
+        auto operator=(producer&&) -> producer& = delete;
+    };
 
-    event_manager();
+private:
+    std::atomic<lane*> m_lanes{ nullptr };
+    std::atomic<std::uint32_t> m_num_lanes{ 0 };
+    std::atomic<std::size_t> m_high_water{ s_capacity };
+    std::atomic<std::size_t> m_low_water{ s_capacity / 2 };
+
+    alignas(cache_line_size) std::atomic<std::uint64_t> m_next_sequence{ 0 };
+
+    // words handed over but not popped yet, including block headers
+    alignas(cache_line_size) std::atomic<std::size_t> m_queued{ 0 };
+
+    // consumer side
+    alignas(cache_line_size) std::uint64_t m_expected_sequence{ 0 };
+    lane* m_reading{ nullptr };
+    std::size_t m_block_left{ 0 };
+    std::size_t m_consumed{ 0 }; // words popped since `m_queued` was last updated
+
+    alignas(cache_line_size) std::atomic<bool> m_closed{ false };
+    std::atomic<int> m_producers_waiting{ 0 };
+    std::mutex m_wait_lock{};
+    std::condition_variable m_room{};
+
+    event_manager() = default;
+
+    [[nodiscard]] static auto local_producer() -> producer&;
+    [[nodiscard]] auto acquire_lane() -> lane*;
+    // Packs `event` into `p`'s block, handing the block over first if it's full.
+    auto append(producer& p, event_data const& event) -> void;
+    // Hands the calling thread's block to the consumer, waiting for room first unless the thread exits.
+    auto publish(producer& p) -> void;
+    // Finds the lane whose next block carries the expected sequence number.
+    [[nodiscard]] auto next_block() noexcept -> bool;
+    // Pops whole events from a single block, at most `max_count - max_packed_event_size + 1` words plus whatever
+    // completes the last event.
+    [[nodiscard]] auto read_block(packed_event* out, std::size_t max_count, std::uint32_t& lane_id) noexcept
+        -> std::size_t;
+    auto release_consumed() noexcept -> void;
+
+    // Blocks a producer until the consumer drained the queue down to the low-water mark or the queue is closed.
+    auto wait_for_room() -> void;
+    auto notify_room() noexcept -> void;
 
 public:
     event_manager(event_manager const&) = delete;
     event_manager(event_manager&&) = delete;
-    ~event_manager() noexcept = default;
+    ~event_manager() noexcept;
 
     auto operator=(event_manager const&) -> event_manager& = delete;
     auto operator=(event_manager &&) -> event_manager& = delete;
 
     [[nodiscard]] static auto instance() -> event_manager&;
 
+    // Any number of threads may push, only one thread may pop. Pushed events become visible to the consumer once
+    // the pushing thread's block fills up, it calls `flush()` or it exits. Once `max_queued()` words are queued a
+    // producer sleeps until the consumer drains them to half of that or the queue is closed, events pushed after
+    // `close()` are dropped. A thread that exits hands its last block over without waiting.
     auto push(event_data const& event) -> void;
+    auto push(event_data const* events, std::size_t count) -> void;
+    // Pushes whole packed events, a multi-word event is never split between two blocks.
+    auto push_packed(packed_event const* words, std::size_t count) -> void;
+    // The calling thread's held back accesses, kept with its block so they are handed over when it exits.
+    [[nodiscard]] static auto held_back() -> held_accesses&;
+    // Hands the calling thread's partial block to the consumer.
+    auto flush() -> void;
     [[nodiscard]] auto pop() -> event_data;
-    [[nodiscard]] auto empty() noexcept -> bool;
+    [[nodiscard]] auto pop(event_data* out, std::size_t max_count) noexcept -> std::size_t;
+    // Pops whole packed events without decoding them, `max_count` must be at least `max_packed_event_size`.
+    [[nodiscard]] auto pop_packed(packed_event* out, std::size_t max_count) noexcept -> std::size_t;
+    // Both count blocks that are still being handed over.
+    [[nodiscard]] auto empty() const noexcept -> bool;
+    // Number of queued packed words, including one header word per block.
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    // High-water mark in packed words (one per event below a billion elements), clamped to `capacity()`.
+    auto set_max_queued(std::size_t words) noexcept -> void;
+    [[nodiscard]] auto max_queued() const noexcept -> std::size_t;
+    [[nodiscard]] static constexpr auto capacity() noexcept -> std::size_t
+    {
+        return s_capacity;
+    }
+
+    auto close() noexcept -> void;
+    [[nodiscard]] auto closed() const noexcept -> bool;
 };
 
 struct normal_emitter
@@ -65,21 +243,110 @@ public:
     static auto on_comparison(element_t i, element_t j) -> void;
     static auto on_modify(element_t i, element_t value) -> void;
     static auto on_end() -> void;
+
+    // With coalescing on (the default) accesses are held back and dropped when the compare, swap or modify that
+    // follows highlights the same elements anyway, so `data[i] > data[j]` costs one event instead of five.
+    // Only switch it while nothing is being sorted.
+    static auto set_coalescing(bool enabled) noexcept -> void;
+    [[nodiscard]] static auto coalescing() noexcept -> bool;
+    // Hands everything the calling thread is still holding back to the consumer, for algorithms that don't end
+    // with `end()`.
+    static auto flush() -> void;
 };
 
-struct test_emitter
+// Emits nothing, arrays using it compile down to plain vector accesses.
+struct null_emitter
 {
 public:
-    static auto on_access(element_t i, element_t val) -> void;
-    static auto on_swap(element_t i, element_t j) -> void;
-    static auto on_comparison(element_t i, element_t j) -> void;
-    static auto on_modify(element_t i, element_t value) -> void;
-    static auto on_end() -> void;
+    static auto on_access(element_t, element_t) noexcept -> void
+    {
+    }
+    static auto on_swap(element_t, element_t) noexcept -> void
+    {
+    }
+    static auto on_comparison(element_t, element_t) noexcept -> void
+    {
+    }
+    static auto on_modify(element_t, element_t) noexcept -> void
+    {
+    }
+    static auto on_end() noexcept -> void
+    {
+    }
+    static auto flush() noexcept -> void
+    {
+    }
+};
+
+struct operation_counts
+{
+    std::uint64_t accesses{ 0 };
+    std::uint64_t comparisons{ 0 };
+    std::uint64_t swaps{ 0 };
+    std::uint64_t modifies{ 0 };
+};
+
+[[nodiscard]] auto operator==(operation_counts const& a, operation_counts const& b) noexcept -> bool;
+[[nodiscard]] auto operator!=(operation_counts const& a, operation_counts const& b) noexcept -> bool;
+
+// Counts operations instead of queueing events. Every thread bumps its own counters, `counts()` adds up all of
+// them, including the ones of threads that already finished.
+struct stats_emitter
+{
+    struct counters
+    {
+        std::atomic<std::uint64_t> accesses{ 0 };
+        std::atomic<std::uint64_t> comparisons{ 0 };
+        std::atomic<std::uint64_t> swaps{ 0 };
+        std::atomic<std::uint64_t> modifies{ 0 };
+    };
+
+private:
+    [[nodiscard]] static auto register_thread() -> counters&;
+
+    [[nodiscard]] static auto local() -> counters&
+    {
+        thread_local counters& local_counters = register_thread();
+        return local_counters;
+    }
+
+    // only the owning thread writes, so a plain load/store pair is enough and avoids a locked instruction
+    static auto bump(std::atomic<std::uint64_t>& counter) noexcept -> void
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+public:
+    static auto on_access(element_t, element_t) -> void
+    {
+        bump(local().accesses);
+    }
+    static auto on_swap(element_t, element_t) -> void
+    {
+        bump(local().swaps);
+    }
+    static auto on_comparison(element_t, element_t) -> void
+    {
+        bump(local().comparisons);
+    }
+    static auto on_modify(element_t, element_t) -> void
+    {
+        bump(local().modifies);
+    }
+    static auto on_end() noexcept -> void
+    {
+    }
+    static auto flush() noexcept -> void
+    {
+    }
+
+    [[nodiscard]] static auto counts() -> operation_counts;
+    static auto reset() -> void;
 };
 
 #ifdef SORTVIS_TESTING
 
-using emitter_t = test_emitter;
+using emitter_t = null_emitter;
 
 #else
 
@@ -87,72 +354,258 @@ using emitter_t = normal_emitter;
 
 #endif
 
-class array_value
+// What emitters are told about a key: the key itself for `element_t`, its radix bits for anything else.
+template<typename Key>
+[[nodiscard]] auto event_value(Key const& key) noexcept -> element_t
+{
+    return static_cast<element_t>(radix_key(key));
+}
+
+template<typename Emitter, typename Key = element_t>
+class basic_array_value
 {
 private:
-    element_t m_value;
+    Key m_value;
     mutable element_t m_index; // where the value comes from
 
 public:
-    array_value() noexcept = default;
-    array_value(array_value const&) noexcept = default;
-    array_value(array_value&&) noexcept = default;
-    ~array_value() noexcept = default;
+    basic_array_value() noexcept = default;
+    basic_array_value(basic_array_value const&) noexcept = default;
+    basic_array_value(basic_array_value&&) noexcept = default;
+    ~basic_array_value() noexcept = default;
 
-    explicit array_value(element_t init);
+    explicit basic_array_value(Key init);
 
-    auto operator=(array_value const&) noexcept -> array_value& = default;
-    auto operator=(array_value&&) noexcept -> array_value& = default;
+    auto operator=(basic_array_value const&) noexcept -> basic_array_value& = default;
+    auto operator=(basic_array_value&&) noexcept -> basic_array_value& = default;
 
-    auto operator=(element_t val) noexcept -> array_value&;
+    auto operator=(Key val) noexcept -> basic_array_value&;
 
     auto set_index(element_t index) const noexcept -> void;
 
-    [[nodiscard]] auto get() const noexcept -> element_t;
-    [[nodiscard]] auto get_raw() const noexcept -> element_t;
+    [[nodiscard]] auto get() const noexcept -> Key;
+    [[nodiscard]] auto get_raw() const noexcept -> Key;
     [[nodiscard]] auto index() const noexcept -> element_t;
 };
 
-[[nodiscard]] auto operator==(array_value const& a, array_value const& b) noexcept -> bool;
-[[nodiscard]] auto operator!=(array_value const& a, array_value const& b) noexcept -> bool;
-[[nodiscard]] auto operator<(array_value const& a, array_value const& b) noexcept -> bool;
-[[nodiscard]] auto operator<=(array_value const& a, array_value const& b) noexcept -> bool;
-[[nodiscard]] auto operator>=(array_value const& a, array_value const& b) noexcept -> bool;
-[[nodiscard]] auto operator>(array_value const& a, array_value const& b) noexcept -> bool;
-
-class array
+// Keys are `element_t` unless given, any type `key_traits` knows works: other integers, floating point numbers and
+// `record`s.
+template<typename Emitter, typename Key = element_t>
+class basic_array
 {
 private:
-    std::vector<array_value> m_data;
+    std::vector<basic_array_value<Emitter, Key>> m_data;
 
 public:
-    array() noexcept = default;
-    array(array const&) = default;
-    array(array&&) noexcept = default;
-    ~array() noexcept = default;
+    using emitter_type = Emitter;
+    using key_type = Key;
+    using value_type = basic_array_value<Emitter, Key>;
+
+    // Whether operations go unobserved, algorithms may then take shortcuts around them.
+    static constexpr bool silent = std::is_same_v<Emitter, null_emitter>;
+
+    basic_array() noexcept = default;
+    basic_array(basic_array const&) = default;
+    basic_array(basic_array&&) noexcept = default;
+    ~basic_array() noexcept = default;
 
-    explicit array(std::vector<element_t> const& input);
+    explicit basic_array(std::vector<Key> const& input);
 
-    auto operator=(array const&) noexcept -> array& = default;
-    auto operator=(array&&) noexcept -> array& = default;
+    auto operator=(basic_array const&) noexcept -> basic_array& = default;
+    auto operator=(basic_array&&) noexcept -> basic_array& = default;
 
     auto swap_at(element_t i, element_t j) -> void;
     auto swap_at(int i, int j) -> void;
-    auto modify(element_t i, element_t val) const -> void;
-    auto modify(int i, int val) const -> void;
+    auto modify(element_t i, Key const& val) const -> void;
+    auto modify(int i, Key const& val) const -> void;
     auto end() -> void;
 
-    [[nodiscard]] auto operator[](element_t index) noexcept -> array_value&;
-    [[nodiscard]] auto operator[](element_t index) const noexcept -> array_value const&;
-    [[nodiscard]] auto operator[](int index) noexcept -> array_value&;
-    [[nodiscard]] auto operator[](int index) const noexcept -> array_value const&;
+    [[nodiscard]] auto operator[](element_t index) noexcept -> value_type&;
+    [[nodiscard]] auto operator[](element_t index) const noexcept -> value_type const&;
+    [[nodiscard]] auto operator[](int index) noexcept -> value_type&;
+    [[nodiscard]] auto operator[](int index) const noexcept -> value_type const&;
 
     [[nodiscard]] auto size() const noexcept -> std::size_t;
     [[nodiscard]] auto isize() const noexcept -> int;
 
     [[nodiscard]] auto is_sorted() const noexcept -> bool;
+
+    // The stored values, for kernels that read their keys with `get_raw()` without emitting anything.
+    [[nodiscard]] auto data() const noexcept -> value_type const*;
 };
 
+using array_value = basic_array_value<emitter_t>;
+using array = basic_array<emitter_t>;
+// Same operations as `array` without any events, for timing algorithms.
+using silent_array = basic_array<null_emitter>;
+// Only counts operations, see `stats_emitter`.
+using counting_array = basic_array<stats_emitter>;
+template<typename Key>
+using silent_array_of = basic_array<null_emitter, Key>;
+
+template<typename Emitter, typename Key>
+basic_array_value<Emitter, Key>::basic_array_value(Key const init)
+    : m_value{ init }
+    , m_index{ 0 }
+{
+}
+
+template<typename Emitter, typename Key>
+auto basic_array_value<Emitter, Key>::operator=(Key const val) noexcept -> basic_array_value&
+{
+    m_value = val;
+    return *this;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array_value<Emitter, Key>::set_index(element_t const index) const noexcept -> void
+{
+    m_index = index;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array_value<Emitter, Key>::get() const noexcept -> Key
+{
+    Emitter::on_access(m_index, event_value(m_value));
+    return m_value;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array_value<Emitter, Key>::get_raw() const noexcept -> Key
+{
+    return m_value;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array_value<Emitter, Key>::index() const noexcept -> element_t
+{
+    return m_index;
+}
+
+#define SORTVIS_ARRAY_VALUE_OPERATOR(op)                                                                               \
+    template<typename Emitter, typename Key>                                                                           \
+    [[nodiscard]] auto operator op(basic_array_value<Emitter, Key> const& a,                                           \
+                                   basic_array_value<Emitter, Key> const& b) noexcept->bool                            \
+    {                                                                                                                  \
+        Emitter::on_comparison(a.index(), b.index());                                                                  \
+        return a.get_raw() op b.get_raw();                                                                             \
+    }
+
+SORTVIS_ARRAY_VALUE_OPERATOR(==)
+SORTVIS_ARRAY_VALUE_OPERATOR(!=)
+SORTVIS_ARRAY_VALUE_OPERATOR(<)
+SORTVIS_ARRAY_VALUE_OPERATOR(<=)
+SORTVIS_ARRAY_VALUE_OPERATOR(>=)
+SORTVIS_ARRAY_VALUE_OPERATOR(>)
+
+#undef SORTVIS_ARRAY_VALUE_OPERATOR
+
+template<typename Emitter, typename Key>
+basic_array<Emitter, Key>::basic_array(std::vector<Key> const& input)
+{
+    m_data.reserve(input.size());
+
+    for(Key const& val : input) {
+        m_data.emplace_back(val);
+    }
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::swap_at(element_t const i, element_t const j) -> void
+{
+    Emitter::on_swap(i, j);
+    std::swap(m_data[i], m_data[j]);
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::swap_at(int const i, int const j) -> void
+{
+    SORTVIS_ASSERT(i >= 0);
+    SORTVIS_ASSERT(j >= 0);
+
+    this->swap_at(static_cast<element_t>(i), static_cast<element_t>(j));
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::modify(element_t const i, Key const& val) const -> void
+{
+    Emitter::on_modify(i, event_value(val));
+    static_cast<void>(m_data); // ignore 'method can be made static'
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::modify(int const i, Key const& val) const -> void
+{
+    SORTVIS_ASSERT(i >= 0);
+
+    this->modify(static_cast<element_t>(i), val);
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::end() -> void
+{
+    Emitter::on_end();
+    static_cast<void>(m_data); // ignore 'method can be made static'
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::operator[](element_t const index) noexcept -> value_type&
+{
+    Emitter::on_access(index, event_value(m_data[index].get_raw()));
+    auto& val = m_data[index];
+    val.set_index(index);
+    return val;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::operator[](element_t const index) const noexcept -> value_type const&
+{
+    Emitter::on_access(index, event_value(m_data[index].get_raw()));
+    auto const& val = m_data[index];
+    val.set_index(index);
+    return val;
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::operator[](int const index) noexcept -> value_type&
+{
+    SORTVIS_ASSERT(index >= 0);
+    return this->operator[](static_cast<element_t>(index));
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::operator[](int const index) const noexcept -> value_type const&
+{
+    SORTVIS_ASSERT(index >= 0);
+    return this->operator[](static_cast<element_t>(index));
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::size() const noexcept -> std::size_t
+{
+    return m_data.size();
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::isize() const noexcept -> int
+{
+    return static_cast<int>(m_data.size());
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::data() const noexcept -> value_type const*
+{
+    return m_data.data();
+}
+
+template<typename Emitter, typename Key>
+auto basic_array<Emitter, Key>::is_sorted() const noexcept -> bool
+{
+    return std::is_sorted(m_data.begin(), m_data.end(), [](value_type const& a, value_type const& b) {
+        return a.get_raw() < b.get_raw();
+    });
+}
+
 } // namespace core
 
 #endif // !SORTVIS_EVENT_HPP
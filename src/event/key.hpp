@@ -0,0 +1,128 @@
+#ifndef SORTVIS_KEY_HPP
+#define SORTVIS_KEY_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace core {
+
+// A key carrying a payload along. Only keys take part in comparisons, which makes it easy to tell whether a sort
+// kept equal keys in their original order.
+template<typename Key, typename Payload>
+struct record
+{
+    Key key;
+    Payload payload;
+};
+
+#define SORTVIS_RECORD_OPERATOR(op)                                                                                    \
+    template<typename Key, typename Payload>                                                                           \
+    [[nodiscard]] constexpr auto operator op(record<Key, Payload> const& a, record<Key, Payload> const& b) noexcept    \
+        ->bool                                                                                                         \
+    {                                                                                                                  \
+        return a.key op b.key;                                                                                         \
+    }
+
+SORTVIS_RECORD_OPERATOR(<)
+SORTVIS_RECORD_OPERATOR(<=)
+SORTVIS_RECORD_OPERATOR(>=)
+SORTVIS_RECORD_OPERATOR(>)
+
+#undef SORTVIS_RECORD_OPERATOR
+
+using key_value = record<std::uint32_t, std::uint32_t>;
+
+template<std::size_t Size>
+struct unsigned_of_size;
+
+template<>
+struct unsigned_of_size<4>
+{
+    using type = std::uint32_t;
+};
+
+template<>
+struct unsigned_of_size<8>
+{
+    using type = std::uint64_t;
+};
+
+// Maps keys to unsigned integers of the same width whose order is the order of the keys, for the radix sorts:
+//   unsigned keys are their own bits,
+//   signed keys get their sign bit flipped,
+//   floating point keys get their sign bit flipped if positive, all their bits if negative (NaNs aren't ordered),
+//   records map their key.
+template<typename Key, typename = void>
+struct key_traits;
+
+template<typename Key>
+struct key_traits<Key, std::enable_if_t<std::is_integral_v<Key>>>
+{
+    using bits_type = typename unsigned_of_size<sizeof(Key)>::type;
+
+    static constexpr bits_type sign_bit = std::is_signed_v<Key> ? bits_type{ 1 } << (sizeof(Key) * 8 - 1) : 0;
+
+    [[nodiscard]] static constexpr auto to_bits(Key const key) noexcept -> bits_type
+    {
+        return static_cast<bits_type>(key) ^ sign_bit;
+    }
+    [[nodiscard]] static constexpr auto from_bits(bits_type const bits) noexcept -> Key
+    {
+        return static_cast<Key>(bits ^ sign_bit);
+    }
+};
+
+template<typename Key>
+struct key_traits<Key, std::enable_if_t<std::is_floating_point_v<Key>>>
+{
+    static_assert(std::numeric_limits<Key>::is_iec559);
+
+    using bits_type = typename unsigned_of_size<sizeof(Key)>::type;
+
+    static constexpr bits_type sign_bit = bits_type{ 1 } << (sizeof(Key) * 8 - 1);
+
+    [[nodiscard]] static auto to_bits(Key const key) noexcept -> bits_type
+    {
+        bits_type bits{};
+        std::memcpy(&bits, &key, sizeof(key));
+
+        return (bits & sign_bit) != 0 ? ~bits : bits | sign_bit;
+    }
+    [[nodiscard]] static auto from_bits(bits_type bits) noexcept -> Key
+    {
+        bits = (bits & sign_bit) != 0 ? bits & ~sign_bit : ~bits;
+
+        Key key{};
+        std::memcpy(&key, &bits, sizeof(key));
+
+        return key;
+    }
+};
+
+template<typename Key, typename Payload>
+struct key_traits<record<Key, Payload>>
+{
+    using bits_type = typename key_traits<Key>::bits_type;
+
+    [[nodiscard]] static auto to_bits(record<Key, Payload> const& value) noexcept -> bits_type
+    {
+        return key_traits<Key>::to_bits(value.key);
+    }
+};
+
+template<typename Key>
+using radix_bits_t = typename key_traits<Key>::bits_type;
+
+template<typename Key>
+[[nodiscard]] auto radix_key(Key const& key) noexcept -> radix_bits_t<Key>
+{
+    return key_traits<Key>::to_bits(key);
+}
+
+} // namespace core
+
+#endif // !SORTVIS_KEY_HPP
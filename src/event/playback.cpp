@@ -0,0 +1,61 @@
+#include "playback.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace core {
+
+playback_clock::playback_clock(double const events_per_second, clock::time_point const now) noexcept
+    : m_last{ now }
+{
+    this->set_rate(events_per_second);
+}
+
+auto playback_clock::rate() const noexcept -> double
+{
+    return m_rate;
+}
+
+auto playback_clock::set_rate(double const events_per_second) noexcept -> void
+{
+    m_rate = (events_per_second <= unlimited) ? unlimited : std::clamp(events_per_second, min_rate, max_rate);
+    m_credit = std::min(m_credit, m_rate * s_max_backlog.count());
+}
+
+auto playback_clock::faster() noexcept -> void
+{
+    if(m_rate != unlimited) {
+        this->set_rate(m_rate * 2.0);
+    }
+}
+
+auto playback_clock::slower() noexcept -> void
+{
+    // halving "unlimited" has no meaning, start slowing down from the fastest finite rate instead
+    this->set_rate((m_rate == unlimited) ? max_rate : m_rate / 2.0);
+}
+
+auto playback_clock::advance(clock::time_point const now) noexcept -> std::size_t
+{
+    std::chrono::duration<double> const elapsed = now - m_last;
+    m_last = now;
+
+    if(m_rate == unlimited) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    m_credit = std::min(m_credit + elapsed.count() * m_rate, m_rate * s_max_backlog.count());
+    return static_cast<std::size_t>(m_credit);
+}
+
+auto playback_clock::consume(std::size_t const played) noexcept -> void
+{
+    m_credit = std::max(m_credit - static_cast<double>(played), 0.0);
+}
+
+auto playback_clock::reset(clock::time_point const now) noexcept -> void
+{
+    m_last = now;
+}
+
+} // namespace core
@@ -0,0 +1,54 @@
+#ifndef SORTVIS_PLAYBACK_HPP
+#define SORTVIS_PLAYBACK_HPP
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace core {
+
+// Turns elapsed wall time into a number of events to play at a target events-per-second rate. Fractional events
+// carry over between frames, but at most `s_max_backlog` worth of them so a stall doesn't turn into a burst.
+class playback_clock
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr double unlimited = 0.0;
+    static constexpr double min_rate = 1.0;
+    static constexpr double max_rate = 1'000'000'000.0;
+
+private:
+    static constexpr std::chrono::duration<double> s_max_backlog{ 0.25 };
+
+    double m_rate{ unlimited };
+    double m_credit{ 0.0 };
+    clock::time_point m_last{};
+
+public:
+    playback_clock() = delete;
+    playback_clock(playback_clock const&) noexcept = default;
+    playback_clock(playback_clock&&) noexcept = default;
+    ~playback_clock() noexcept = default;
+
+    explicit playback_clock(double events_per_second, clock::time_point now = clock::now()) noexcept;
+
+    auto operator=(playback_clock const&) noexcept -> playback_clock& = default;
+    auto operator=(playback_clock&&) noexcept -> playback_clock& = default;
+
+    [[nodiscard]] auto rate() const noexcept -> double;
+    auto set_rate(double events_per_second) noexcept -> void;
+    auto faster() noexcept -> void;
+    auto slower() noexcept -> void;
+
+    // How many events are due at `now`, everything when the rate is unlimited.
+    [[nodiscard]] auto advance(clock::time_point now) noexcept -> std::size_t;
+    // Spend the credit for `played` events.
+    auto consume(std::size_t played) noexcept -> void;
+    // Forget the time elapsed since the last call, e.g. while paused.
+    auto reset(clock::time_point now) noexcept -> void;
+};
+
+} // namespace core
+
+#endif // !SORTVIS_PLAYBACK_HPP
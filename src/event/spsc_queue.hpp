@@ -0,0 +1,166 @@
+#ifndef SORTVIS_SPSC_QUEUE_HPP
+#define SORTVIS_SPSC_QUEUE_HPP
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace core {
+
+inline constexpr std::size_t cache_line_size = 64;
+
+// Bounded, wait-free single-producer/single-consumer ring.
+// Head and tail live on separate cache lines and each side caches the other's index, so the shared line is only
+// reloaded when the ring looks full (producer) or empty (consumer). Bulk push/pop publish a batch with one store.
+template<typename T>
+class spsc_queue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "spsc_queue only stores trivially copyable types");
+
+private:
+    std::size_t m_mask;
+    std::unique_ptr<T[]> m_buffer; // NOLINT
+
+    alignas(cache_line_size) std::atomic<std::size_t> m_head{ 0 };
+    std::size_t m_cached_tail{ 0 };
+
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail{ 0 };
+    std::size_t m_cached_head{ 0 };
+
+    [[nodiscard]] static constexpr auto round_up_pow2(std::size_t const x) noexcept -> std::size_t
+    {
+        std::size_t result = 1;
+
+        while(result < x) {
+            result <<= 1U;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] auto writable(std::size_t const tail, std::size_t const wanted) noexcept -> std::size_t
+    {
+        auto free_slots = this->capacity() - (tail - m_cached_head);
+
+        if(free_slots < wanted) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            free_slots = this->capacity() - (tail - m_cached_head);
+        }
+
+        return std::min(free_slots, wanted);
+    }
+
+    [[nodiscard]] auto readable(std::size_t const head, std::size_t const wanted) noexcept -> std::size_t
+    {
+        auto available = m_cached_tail - head;
+
+        if(available < wanted) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            available = m_cached_tail - head;
+        }
+
+        return std::min(available, wanted);
+    }
+
+public:
+    spsc_queue() = delete;
+    spsc_queue(spsc_queue const&) = delete;
+    spsc_queue(spsc_queue&&) = delete;
+    ~spsc_queue() noexcept = default;
+
+    // capacity is rounded up to the next power of two
+    explicit spsc_queue(std::size_t const capacity)
+        : m_mask{ round_up_pow2(std::max<std::size_t>(capacity, 2)) - 1 }
+        , m_buffer{ std::make_unique<T[]>(m_mask + 1) } // NOLINT
+    {
+    }
+
+    auto operator=(spsc_queue const&) -> spsc_queue& = delete;
+    auto operator=(spsc_queue&&) -> spsc_queue& = delete;
+
+    // Producer side.
+    [[nodiscard]] auto try_push(T const& item) noexcept -> bool
+    {
+        return this->try_push(&item, 1) == 1;
+    }
+
+    // Producer side, returns how many of `items` fit in the ring.
+    [[nodiscard]] auto try_push(T const* const items, std::size_t const count) noexcept -> std::size_t
+    {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        auto const n = this->writable(tail, count);
+
+        for(std::size_t k = 0; k < n; ++k) {
+            m_buffer[(tail + k) & m_mask] = items[k]; // NOLINT
+        }
+
+        if(n > 0) {
+            m_tail.store(tail + n, std::memory_order_release);
+        }
+
+        return n;
+    }
+
+    // Producer side, whether `count` items fit in the ring. The consumer only frees slots, so they keep fitting.
+    [[nodiscard]] auto can_push(std::size_t const count) noexcept -> bool
+    {
+        return this->writable(m_tail.load(std::memory_order_relaxed), count) == count;
+    }
+
+    // Producer side, pushes either all of `items` or none of them.
+    [[nodiscard]] auto try_push_all(T const* const items, std::size_t const count) noexcept -> bool
+    {
+        if(!this->can_push(count)) {
+            return false;
+        }
+
+        return this->try_push(items, count) == count;
+    }
+
+    // Consumer side.
+    [[nodiscard]] auto try_pop(T& item) noexcept -> bool
+    {
+        return this->try_pop(&item, 1) == 1;
+    }
+
+    // Consumer side, returns how many items were written to `out`.
+    [[nodiscard]] auto try_pop(T* const out, std::size_t const max_count) noexcept -> std::size_t
+    {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        auto const n = this->readable(head, max_count);
+
+        for(std::size_t k = 0; k < n; ++k) {
+            out[k] = m_buffer[(head + k) & m_mask]; // NOLINT
+        }
+
+        if(n > 0) {
+            m_head.store(head + n, std::memory_order_release);
+        }
+
+        return n;
+    }
+
+    // Exact on the consumer side, a snapshot anywhere else.
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        auto const head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return m_mask + 1;
+    }
+};
+
+} // namespace core
+
+#endif // !SORTVIS_SPSC_QUEUE_HPP
@@ -0,0 +1,195 @@
+#include "trace.hpp"
+#include "log/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SORTVIS_HAS_MMAP
+#endif
+
+namespace core {
+
+namespace {
+
+constexpr std::array<char, 8> g_trace_magic = { 'S', 'V', 'T', 'R', 'A', 'C', 'E', '\0' };
+constexpr std::uint64_t g_trace_version = 1;
+
+static_assert(sizeof(trace_header) % sizeof(packed_event) == 0, "events must stay word aligned");
+static_assert(sizeof(element_t) == sizeof(std::uint64_t), "traces store elements as 64 bit words");
+
+} // namespace
+
+trace_writer::trace_writer(std::string const& path, trace_info const& info)
+    : m_file{ std::fopen(path.c_str(), "wb") }
+{
+    if(m_file == nullptr) {
+        throw std::runtime_error{ "Couldn't create trace file '" + path + "'" };
+    }
+
+    constexpr std::size_t buffer_size = 1U << 20U;
+    std::setvbuf(m_file, nullptr, _IOFBF, buffer_size);
+
+    trace_header header{};
+    header.magic = g_trace_magic;
+    header.version = g_trace_version;
+    header.size = info.initial_data.size();
+    header.seed = info.seed;
+
+    auto const name_length = std::min(info.algorithm.size(), trace_header::max_algorithm_name - 1);
+    std::copy_n(info.algorithm.begin(), name_length, header.algorithm.begin());
+
+    this->write_raw(&header, sizeof(header));
+    this->write_raw(info.initial_data.data(), info.initial_data.size() * sizeof(element_t));
+}
+
+trace_writer::~trace_writer() noexcept
+{
+    if(std::fclose(m_file) != 0) {
+        ERROR("Couldn't finish writing the trace file");
+    }
+}
+
+auto trace_writer::write_raw(void const* const data, std::size_t const bytes) -> void
+{
+    if(bytes > 0 && std::fwrite(data, 1, bytes, m_file) != bytes) {
+        throw std::runtime_error{ "Couldn't write to the trace file" };
+    }
+}
+
+auto trace_writer::write(packed_event const* const words, std::size_t const count) -> void
+{
+    this->write_raw(words, count * sizeof(packed_event));
+}
+
+mapped_file::mapped_file(std::string const& path)
+{
+#ifdef SORTVIS_HAS_MMAP
+    int const fd = ::open(path.c_str(), O_RDONLY); // NOLINT
+
+    if(fd < 0) {
+        throw std::runtime_error{ "Couldn't open '" + path + "'" };
+    }
+
+    struct stat info
+    {
+    };
+
+    if(::fstat(fd, &info) == 0 && info.st_size > 0) {
+        m_size = static_cast<std::size_t>(info.st_size);
+        m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(m_data == MAP_FAILED) { // NOLINT
+            m_data = nullptr;
+            m_size = 0;
+        }
+        else {
+            ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+    }
+
+    ::close(fd);
+
+    if(m_data != nullptr) {
+        return;
+    }
+#endif
+
+    std::ifstream file{ path, std::ios::binary | std::ios::ate };
+
+    if(!file) {
+        throw std::runtime_error{ "Couldn't open '" + path + "'" };
+    }
+
+    m_size = static_cast<std::size_t>(file.tellg());
+    m_fallback.resize(m_size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_fallback.data()), static_cast<std::streamsize>(m_size)); // NOLINT
+}
+
+mapped_file::~mapped_file() noexcept
+{
+#ifdef SORTVIS_HAS_MMAP
+    if(m_data != nullptr) {
+        ::munmap(m_data, m_size);
+    }
+#endif
+}
+
+auto mapped_file::data() const noexcept -> unsigned char const*
+{
+    return (m_data != nullptr) ? static_cast<unsigned char const*>(m_data) : m_fallback.data();
+}
+
+auto mapped_file::size() const noexcept -> std::size_t
+{
+    return m_size;
+}
+
+trace_reader::trace_reader(std::string const& path)
+    : m_file{ path }
+{
+    trace_header header{};
+
+    if(m_file.size() < sizeof(header)) {
+        throw std::runtime_error{ "'" + path + "' is not a trace file" };
+    }
+
+    std::memcpy(&header, m_file.data(), sizeof(header));
+
+    if(header.magic != g_trace_magic || header.version != g_trace_version) {
+        throw std::runtime_error{ "'" + path + "' is not a trace file (or was written by another version)" };
+    }
+
+    // compared in elements, a corrupt size would wrap around in bytes
+    if(header.size > (m_file.size() - sizeof(header)) / sizeof(element_t)) {
+        throw std::runtime_error{ "'" + path + "' is truncated" };
+    }
+
+    auto const data_bytes = header.size * sizeof(element_t);
+
+    header.algorithm.back() = '\0';
+    m_info.algorithm = header.algorithm.data();
+    m_info.seed = header.seed;
+    m_info.initial_data.resize(header.size);
+    std::memcpy(m_info.initial_data.data(), m_file.data() + sizeof(header), data_bytes); // NOLINT
+
+    auto const events_offset = sizeof(header) + data_bytes;
+    m_events = reinterpret_cast<packed_event const*>(m_file.data() + events_offset); // NOLINT
+    m_num_words = (m_file.size() - events_offset) / sizeof(packed_event);
+}
+
+auto trace_reader::info() const noexcept -> trace_info const&
+{
+    return m_info;
+}
+
+auto trace_reader::read(event_data* const out, std::size_t const max_count) noexcept -> std::size_t
+{
+    std::size_t count = 0;
+
+    while(count < max_count && m_position < m_num_words) {
+        if(m_position + packed_size(m_events[m_position]) > m_num_words) { // NOLINT
+            // the recording was cut short in the middle of an event
+            m_position = m_num_words;
+            break;
+        }
+
+        m_position += unpack(m_events + m_position, out[count++]); // NOLINT
+    }
+
+    return count;
+}
+
+auto trace_reader::done() const noexcept -> bool
+{
+    return m_position >= m_num_words;
+}
+
+} // namespace core
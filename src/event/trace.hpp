@@ -0,0 +1,111 @@
+#ifndef SORTVIS_TRACE_HPP
+#define SORTVIS_TRACE_HPP
+#pragma once
+
+#include "event.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// On-disk layout: a `trace_header`, `size` words of initial data and then packed events until the end of the file.
+struct trace_header
+{
+    static constexpr std::size_t max_algorithm_name = 32;
+
+    std::array<char, 8> magic{};
+    std::uint64_t version{ 0 };
+    std::array<char, max_algorithm_name> algorithm{};
+    std::uint64_t size{ 0 };
+    std::uint64_t seed{ 0 };
+};
+
+struct trace_info
+{
+    std::string algorithm;
+    std::uint64_t seed{ 0 };
+    std::vector<element_t> initial_data;
+};
+
+class trace_writer
+{
+private:
+    std::FILE* m_file{ nullptr };
+
+    auto write_raw(void const* data, std::size_t bytes) -> void;
+
+public:
+    trace_writer() = delete;
+    trace_writer(trace_writer const&) = delete;
+    trace_writer(trace_writer&&) = delete;
+    ~trace_writer() noexcept;
+
+    // Throws std::runtime_error if the file can't be created.
+    trace_writer(std::string const& path, trace_info const& info);
+
+    auto operator=(trace_writer const&) -> trace_writer& = delete;
+    auto operator=(trace_writer&&) -> trace_writer& = delete;
+
+    // Appends whole packed events, as returned by `event_manager::pop_packed`.
+    auto write(packed_event const* words, std::size_t count) -> void;
+};
+
+// Read-only view of a whole file, memory mapped where the platform allows it.
+class mapped_file
+{
+private:
+    void* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+    std::vector<unsigned char> m_fallback{};
+
+public:
+    mapped_file() = delete;
+    mapped_file(mapped_file const&) = delete;
+    mapped_file(mapped_file&&) = delete;
+    ~mapped_file() noexcept;
+
+    explicit mapped_file(std::string const& path);
+
+    auto operator=(mapped_file const&) -> mapped_file& = delete;
+    auto operator=(mapped_file&&) -> mapped_file& = delete;
+
+    [[nodiscard]] auto data() const noexcept -> unsigned char const*;
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+};
+
+class trace_reader
+{
+private:
+    mapped_file m_file;
+    trace_info m_info{};
+    packed_event const* m_events{ nullptr };
+    std::size_t m_num_words{ 0 };
+    std::size_t m_position{ 0 };
+
+public:
+    trace_reader() = delete;
+    trace_reader(trace_reader const&) = delete;
+    trace_reader(trace_reader&&) = delete;
+    ~trace_reader() noexcept = default;
+
+    // Throws std::runtime_error if the file can't be opened or isn't a trace.
+    explicit trace_reader(std::string const& path);
+
+    auto operator=(trace_reader const&) -> trace_reader& = delete;
+    auto operator=(trace_reader&&) -> trace_reader& = delete;
+
+    [[nodiscard]] auto info() const noexcept -> trace_info const&;
+
+    // Decodes up to `max_count` events, returns how many were decoded.
+    [[nodiscard]] auto read(event_data* out, std::size_t max_count) noexcept -> std::size_t;
+    [[nodiscard]] auto done() const noexcept -> bool;
+};
+
+} // namespace core
+
+#endif // !SORTVIS_TRACE_HPP
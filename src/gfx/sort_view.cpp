@@ -3,6 +3,7 @@
 
 #include <glad/glad.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 
@@ -10,6 +11,18 @@
 
 namespace gfx {
 
+namespace {
+
+// highlight colors of the lanes after the first one, which uses the configured highlight color
+constexpr std::array<color, 6> g_lane_colors = { { { 0.0F, 0.6F, 1.0F, 1.0F },
+                                                   { 1.0F, 0.8F, 0.0F, 1.0F },
+                                                   { 0.8F, 0.2F, 1.0F, 1.0F },
+                                                   { 0.0F, 1.0F, 0.8F, 1.0F },
+                                                   { 1.0F, 0.5F, 0.0F, 1.0F },
+                                                   { 1.0F, 1.0F, 1.0F, 1.0F } } };
+
+} // namespace
+
 auto sort_view::create_shader(sort_view::shader_type const type) noexcept -> unsigned int
 {
     auto const* source =
@@ -182,8 +195,10 @@ sort_view::~sort_view() noexcept
     glDeleteProgram(m_shader_id);
 }
 
-auto sort_view::draw() const noexcept -> void
+auto sort_view::draw() noexcept -> void
 {
+    this->upload();
+
     glUseProgram(m_shader_id);
     glBindVertexArray(m_vao_id);
 
@@ -193,13 +208,24 @@ auto sort_view::draw() const noexcept -> void
     glUseProgram(0);
 }
 
-auto sort_view::undo_previous_event() -> void
+auto sort_view::undo_previous_event(std::uint32_t const lane) -> void
 {
-    for(auto const& c : m_last_color) {
+    if(lane >= m_last_color.size()) {
+        m_last_color.resize(lane + 1);
+    }
+
+    for(auto const& c : m_last_color[lane]) {
         this->update_rect_color(c.first, c.second);
     }
 
-    m_last_color.clear();
+    m_last_color[lane].clear();
+}
+
+auto sort_view::highlight(core::element_t const index, std::uint32_t const lane) -> void
+{
+    m_last_color[lane].emplace_back(index, m_generate_color(m_data_copy[index]));
+    this->update_rect_color(index,
+                            (lane == 0) ? m_highlight_color : g_lane_colors.at((lane - 1) % g_lane_colors.size()));
 }
 
 auto sort_view::update_rect_color(core::element_t const index, color const& col) -> void
@@ -211,25 +237,50 @@ auto sort_view::update_rect_color(core::element_t const index, color const& col)
         m_data[data_offset + offset].col = col;
     }
 
+    this->mark_dirty(index);
+}
+
+auto sort_view::mark_dirty(core::element_t const index) noexcept -> void
+{
+    if(m_dirty_begin == m_dirty_end) {
+        m_dirty_begin = index;
+        m_dirty_end = index + 1;
+        return;
+    }
+
+    m_dirty_begin = std::min(m_dirty_begin, index);
+    m_dirty_end = std::max(m_dirty_end, index + 1);
+}
+
+auto sort_view::upload() noexcept -> void
+{
+    if(m_dirty_begin == m_dirty_end) {
+        return;
+    }
+
+    constexpr core::element_t num_vertices_per_rect = s_num_vertices_per_rect;
+    core::element_t const data_offset = m_dirty_begin * num_vertices_per_rect;
+    core::element_t const data_size = (m_dirty_end - m_dirty_begin) * num_vertices_per_rect;
+
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo_id);
     glBufferSubData(GL_ARRAY_BUFFER,
                     static_cast<GLintptr>(data_offset * sizeof(vertex)),
-                    num_vertices_per_rect * sizeof(vertex),
+                    static_cast<GLsizeiptr>(data_size * sizeof(vertex)),
                     &m_data[data_offset]);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_dirty_begin = m_dirty_end = 0;
 }
 
-auto sort_view::access(core::element_t const i) -> void
+auto sort_view::access(core::element_t const i, std::uint32_t const lane) -> void
 {
-    this->undo_previous_event();
-    // m_last_color.emplace_back(i, m_data[i * s_num_vertices_per_rect].col);
-    m_last_color.emplace_back(i, m_generate_color(m_data_copy[i]));
-    this->update_rect_color(i, m_highlight_color);
+    this->undo_previous_event(lane);
+    this->highlight(i, lane);
 }
 
-auto sort_view::swap(core::element_t const i, core::element_t const j) -> void
+auto sort_view::swap(core::element_t const i, core::element_t const j, std::uint32_t const lane) -> void
 {
-    this->undo_previous_event();
+    this->undo_previous_event(lane);
 
     std::swap(m_data_copy[i], m_data_copy[j]);
 
@@ -241,20 +292,16 @@ auto sort_view::swap(core::element_t const i, core::element_t const j) -> void
     }
 
     for(auto const index : { i, j }) {
-        // m_last_color.emplace_back(index, m_data[index * num_vertices_per_rect].col);
-        m_last_color.emplace_back(index, m_generate_color(m_data_copy[index]));
-        this->update_rect_color(index, m_highlight_color);
+        this->highlight(index, lane);
     }
 }
 
-auto sort_view::compare(core::element_t const i, core::element_t const j) -> void
+auto sort_view::compare(core::element_t const i, core::element_t const j, std::uint32_t const lane) -> void
 {
-    this->undo_previous_event();
+    this->undo_previous_event(lane);
 
     for(auto const index : { i, j }) {
-        // m_last_color.emplace_back(index, m_data[index * s_num_vertices_per_rect].col);
-        m_last_color.emplace_back(index, m_generate_color(m_data_copy[index]));
-        this->update_rect_color(index, m_highlight_color);
+        this->highlight(index, lane);
     }
 }
 
@@ -263,9 +310,9 @@ auto sort_view::divide(core::element_t const a, core::element_t const b) -> floa
     return (static_cast<float>(a) / static_cast<float>(b)) * 2 - 1.0F;
 }
 
-auto sort_view::modify(core::element_t const i, core::element_t const val) -> void
+auto sort_view::modify(core::element_t const i, core::element_t const val, std::uint32_t const lane) -> void
 {
-    this->undo_previous_event();
+    this->undo_previous_event(lane);
 
     m_data_copy[i] = val;
     std::array<vertex, s_num_vertices_per_rect> v;
@@ -281,7 +328,14 @@ auto sort_view::modify(core::element_t const i, core::element_t const val) -> vo
 
 auto sort_view::end() -> void
 {
-    this->undo_previous_event();
+    for(std::uint32_t lane = 0; lane < m_last_color.size(); ++lane) {
+        this->undo_previous_event(lane);
+    }
+}
+
+auto sort_view::value(core::element_t const i) const -> core::element_t
+{
+    return m_data_copy[i];
 }
 
 } // namespace gfx
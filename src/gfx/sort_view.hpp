@@ -3,6 +3,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -62,7 +63,12 @@ private:
     };
 
     std::vector<core::element_t> m_data_copy{};
-    std::vector<std::pair<std::size_t, color>> m_last_color{};
+    // the rects each lane highlighted last, with the color to restore, so threads don't erase each other's
+    std::vector<std::vector<std::pair<std::size_t, color>>> m_last_color{};
+
+    // rects [m_dirty_begin, m_dirty_end) changed since the last upload to the GPU
+    core::element_t m_dirty_begin{ 0 };
+    core::element_t m_dirty_end{ 0 };
 
     inline static char const s_vertex_shader_source[] = R"(#version 330 core
 
@@ -100,8 +106,11 @@ private:
     [[nodiscard]] static auto create_shader(shader_type type) noexcept -> unsigned int;
     [[nodiscard]] static auto create_program(unsigned int vs, unsigned int fs) noexcept -> unsigned int;
 
-    auto undo_previous_event() -> void;
+    auto undo_previous_event(std::uint32_t lane) -> void;
+    auto highlight(core::element_t index, std::uint32_t lane) -> void;
     auto update_rect_color(core::element_t index, color const& col) -> void;
+    auto mark_dirty(core::element_t index) noexcept -> void;
+    auto upload() noexcept -> void;
 
 public:
     sort_view() = delete;
@@ -114,13 +123,18 @@ public:
     auto operator=(sort_view const&) -> sort_view& = default;
     auto operator=(sort_view&&) noexcept -> sort_view& = default;
 
-    auto draw() const noexcept -> void;
+    // Any number of events can be applied between two draws, the changed vertices are uploaded once per draw.
+    auto draw() noexcept -> void;
 
-    auto access(core::element_t i) -> void;
-    auto swap(core::element_t i, core::element_t j) -> void;
-    auto compare(core::element_t i, core::element_t j) -> void;
-    auto modify(core::element_t i, core::element_t val) -> void;
+    // `lane` tells apart events of different sorting threads, every lane highlights in its own color.
+    auto access(core::element_t i, std::uint32_t lane = 0) -> void;
+    auto swap(core::element_t i, core::element_t j, std::uint32_t lane = 0) -> void;
+    auto compare(core::element_t i, core::element_t j, std::uint32_t lane = 0) -> void;
+    auto modify(core::element_t i, core::element_t val, std::uint32_t lane = 0) -> void;
     auto end() -> void;
+
+    // The value shown at `i` after the events applied so far.
+    [[nodiscard]] auto value(core::element_t i) const -> core::element_t;
 };
 
 } // namespace gfx
@@ -85,6 +85,14 @@ auto window::handle_events() noexcept -> void
                 m_on_key_press(key_event::right);
                 break;
             }
+            case SDLK_UP: {
+                m_on_key_press(key_event::up);
+                break;
+            }
+            case SDLK_DOWN: {
+                m_on_key_press(key_event::down);
+                break;
+            }
             case SDLK_s: {
                 m_on_key_press(key_event::s);
                 break;
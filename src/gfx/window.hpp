@@ -16,6 +16,8 @@ enum class key_event
 {
     space,
     right,
+    up,
+    down,
     s
 };
 
@@ -1,7 +1,11 @@
 #include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "algorithm/external_sort.hpp"
 #include "algorithm/random.hpp"
 #include "audio/audio.hpp"
 #include "event/event.hpp"
+#include "event/playback.hpp"
+#include "event/trace.hpp"
 #include "gfx/graphics.hpp"
 #include "gfx/sort_view.hpp"
 #include "gfx/window.hpp"
@@ -9,25 +13,20 @@
 
 #include <docopt/docopt.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <map>
-#include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <unordered_map>
-
-[[nodiscard]] auto generate_data(core::element_t const count) -> std::vector<core::element_t>
-{
-    std::vector<core::element_t> result{};
-
-    result.resize(count);
-    std::iota(result.begin(), result.end(), 1);
-    core::random_shuffle(result);
-
-    return result;
-}
+#include <vector>
 
 char const g_usage[] = R"(SortVisualizer
 
@@ -40,7 +39,14 @@ Usage:
                       [(--color-from=<rect_color_from> --color-to=<rect_color_to>)]
                       [--highlight-color=<rect_hl_color>]
                       [--delay-ms=<delay>]
+                      [--events-per-second=<rate>]
                       [--sound-delay-ms=<sound_delay>]
+                      [--seed=<seed>]
+                      [--distribution=<shape>]
+                      [--max-queued-events=<count>]
+                      [--raw-events]
+                      [--external=<file> [--memory-limit=<bytes>] [--external-keys=<count>]]
+                      [--record=<file> | --replay=<file> | --benchmark | --stats]
 
 Options:
     -h --help                          Show this screen.
@@ -52,32 +58,92 @@ Options:
     --color-to=<rect_color_to>         Gradient color end.
     --highlight-color=<rect_hl_color>  Color to highlight elements.
     --delay-ms=<delay>                 Delay time between sorting events in milliseconds [default: 15].
+    --events-per-second=<rate>         How many sorting events to play per second, 0 means as fast as possible.
+                                       Overrides --delay-ms. Use UP/DOWN to change it while running.
     --sound-delay-ms=<sound_delay>     Delay used by the sound library [default: 10].
+    --seed=<seed>                      Seed used to generate the input, random if not given.
+    --distribution=<shape>             What the input looks like (values: 'shuffled' | 'sorted' | 'reversed' |
+                                       'nearly_sorted' | 'few_unique' | 'sawtooth' | 'organ_pipe' | 'zipf' |
+                                       'gaussian' | 'all_equal' | 'staggered') [default: shuffled].
+    --max-queued-events=<count>        How far the sort may run ahead of playback, it waits once this many events
+                                       are queued and resumes at half of that, at most 262144 [default: 262144].
+    --raw-events                       Keep every access event instead of folding the ones a compare, swap or modify
+                                       right after them highlights anyway.
+    --record=<file>                    Sort without a window and save every event to <file>.
+    --replay=<file>                    Play back a file saved with --record instead of sorting.
+    --external=<file>                  Sort the 64-bit keys in <file> into <file>.sorted without loading all of them,
+                                       --algorithm sorts the runs. The view shows --size evenly spaced keys.
+    --memory-limit=<bytes>             How much of the keys --external holds in memory [default: 268435456].
+    --external-keys=<count>            Fill the --external file with this many random keys first.
+    --benchmark                        Time the algorithm without a window or any events and exit.
+    --stats                            Count the operations of the algorithm without a window and exit.
 )";
 
-using algorithm_t = void (*)(core::array&);
+struct algorithm_entry
+{
+    void (*visual)(core::array&);
+    void (*silent)(core::silent_array&);
+    void (*counting)(core::counting_array&);
+};
+
+#define SORTVIS_ALGORITHM(name)                                                                                        \
+    {                                                                                                                  \
+        #name, algorithm_entry                                                                                         \
+        {                                                                                                              \
+            &core::algorithm::name<core::array>, &core::algorithm::name<core::silent_array>,                           \
+                &core::algorithm::name<core::counting_array>                                                           \
+        }                                                                                                              \
+    }
 
-std::unordered_map<std::string, algorithm_t> g_algorithms = { { "count_sort", &core::algorithm::count_sort },
-                                                              { "bubble_sort", &core::algorithm::bubble_sort },
-                                                              { "insertion_sort", &core::algorithm::insertion_sort },
-                                                              { "radix_sort", &core::algorithm::radix_sort },
-                                                              { "radix_sort_simple",
-                                                                &core::algorithm::radix_sort_simple },
-                                                              { "quicksort", &core::algorithm::quicksort },
-                                                              { "merge_sort", &core::algorithm::merge_sort } };
+std::unordered_map<std::string, algorithm_entry> const g_algorithms = {
+    SORTVIS_ALGORITHM(count_sort),         SORTVIS_ALGORITHM(bubble_sort),
+    SORTVIS_ALGORITHM(insertion_sort),     SORTVIS_ALGORITHM(radix_sort),
+    SORTVIS_ALGORITHM(quicksort),          SORTVIS_ALGORITHM(merge_sort),
+    SORTVIS_ALGORITHM(radix_sort_simple),  SORTVIS_ALGORITHM(parallel_merge_sort),
+    SORTVIS_ALGORITHM(parallel_quicksort), SORTVIS_ALGORITHM(parallel_radix_sort),
+    SORTVIS_ALGORITHM(pdqsort),            SORTVIS_ALGORITHM(timsort),
+    SORTVIS_ALGORITHM(american_flag_sort), SORTVIS_ALGORITHM(merge_sort_bottom_up),
+    SORTVIS_ALGORITHM(sorting_network),    SORTVIS_ALGORITHM(heap_sort),
+    SORTVIS_ALGORITHM(heap_sort_4ary),     SORTVIS_ALGORITHM(heap_sort_8ary),
+    SORTVIS_ALGORITHM(heap_sort_bottom_up), SORTVIS_ALGORITHM(samplesort),
+    SORTVIS_ALGORITHM(multiway_merge_sort)
+};
+
+#undef SORTVIS_ALGORITHM
 
 std::unordered_map<std::string, gfx::color> const g_colors = { { "red", { 1.0F, 0.0F, 0.0F, 1.0F } },
                                                                { "green", { 0.0F, 1.0F, 0.0F, 1.0F } },
                                                                { "blue", { 0.0F, 0.0F, 1.0F, 1.0F } },
                                                                { "white", { 1.0F, 1.0F, 1.0F, 1.0F } } };
 
-auto configure(std::map<std::string, docopt::value> args,
-               core::element_t& size,
-               algorithm_t& algo,
-               std::chrono::milliseconds& delay,
-               double& sound_delay,
-               gfx::sort_view_config& cfg) -> void
+struct settings
+{
+    static constexpr core::element_t default_size = 10;
+    static constexpr double default_events_per_second = 1'000.0 / 15.0;
+    static constexpr double default_sound_delay = 10.0;
+
+    core::element_t size = default_size;
+    std::string algorithm = "bubble_sort";
+    double events_per_second = default_events_per_second;
+    double sound_delay = default_sound_delay;
+    std::optional<std::uint64_t> seed{};
+    core::distribution distribution = core::distribution::shuffled;
+    std::size_t max_queued_events = core::event_manager::capacity();
+    bool raw_events = false;
+    std::string record_path{};
+    std::string replay_path{};
+    std::string external_path{};
+    std::size_t memory_limit = core::external_sort_config{}.memory_limit;
+    std::optional<std::uint64_t> external_keys{};
+    bool benchmark = false;
+    bool stats = false;
+    gfx::sort_view_config view{};
+};
+
+auto configure(std::map<std::string, docopt::value> args, settings& s) -> void
 {
+    auto& cfg = s.view;
+
     if(args["--size"].isString()) {
         auto new_size = std::stoul(args["--size"].asString());
 
@@ -86,13 +152,13 @@ auto configure(std::map<std::string, docopt::value> args,
             new_size = min_limit;
         }
 
-        size = new_size;
+        s.size = new_size;
     }
     if(args["--algorithm"].isString()) {
         auto const algorithm = args["--algorithm"].asString();
 
         if(g_algorithms.find(algorithm) != g_algorithms.end()) {
-            algo = g_algorithms.at(algorithm);
+            s.algorithm = algorithm;
         }
     }
     if(args["--type"].isString()) {
@@ -133,12 +199,260 @@ auto configure(std::map<std::string, docopt::value> args,
             cfg.highlight_color = g_colors.at(color_str);
         }
     }
-    if(args["--delay-ms"].isString()) {
-        auto const delay_ms = args["--delay-ms"].asString();
-        delay = std::chrono::milliseconds(std::stoi(delay_ms));
+    if(args["--events-per-second"].isString()) {
+        s.events_per_second = std::stod(args["--events-per-second"].asString());
+    }
+    else if(args["--delay-ms"].isString()) {
+        constexpr double ms_per_second = 1'000.0;
+        auto const delay_ms = std::stod(args["--delay-ms"].asString());
+        s.events_per_second = (delay_ms > 0.0) ? ms_per_second / delay_ms : core::playback_clock::unlimited;
     }
     if(args["--sound-delay-ms"].isString()) {
-        sound_delay = std::stod(args["--sound-delay-ms"].asString());
+        s.sound_delay = std::stod(args["--sound-delay-ms"].asString());
+    }
+    if(args["--seed"].isString()) {
+        s.seed = std::stoull(args["--seed"].asString());
+    }
+    if(args["--distribution"].isString()) {
+        auto const name = args["--distribution"].asString();
+
+        if(auto const distribution = core::parse_distribution(name); distribution.has_value()) {
+            s.distribution = *distribution;
+        }
+        else {
+            WARN("Unknown distribution '{}', using shuffled", name);
+        }
+    }
+    if(args["--max-queued-events"].isString()) {
+        s.max_queued_events = std::stoul(args["--max-queued-events"].asString());
+    }
+    if(args["--raw-events"].isBool()) {
+        s.raw_events = args["--raw-events"].asBool();
+    }
+    if(args["--record"].isString()) {
+        s.record_path = args["--record"].asString();
+    }
+    if(args["--replay"].isString()) {
+        s.replay_path = args["--replay"].asString();
+    }
+    if(args["--external"].isString()) {
+        s.external_path = args["--external"].asString();
+    }
+    if(args["--memory-limit"].isString()) {
+        s.memory_limit = std::stoull(args["--memory-limit"].asString());
+    }
+    if(args["--external-keys"].isString()) {
+        s.external_keys = std::stoull(args["--external-keys"].asString());
+    }
+    if(args["--benchmark"].isBool()) {
+        s.benchmark = args["--benchmark"].asBool();
+    }
+    if(args["--stats"].isBool()) {
+        s.stats = args["--stats"].asBool();
+    }
+}
+
+// Runs the uninstrumented version of the algorithm, nothing but the sort itself is timed.
+auto benchmark(settings const& s, std::vector<core::element_t> const& data) -> void
+{
+    core::silent_array input{ data };
+
+    auto const start = std::chrono::steady_clock::now();
+    g_algorithms.at(s.algorithm).silent(input);
+    auto const end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> const elapsed = end - start;
+    std::cout << s.algorithm << " on " << data.size() << " elements: " << elapsed.count() << " ms"
+              << (input.is_sorted() ? "" : " (NOT SORTED)") << std::endl;
+}
+
+// Counts operations instead of producing events, so it works on inputs far too large to visualize.
+auto stats(settings const& s, std::vector<core::element_t> const& data) -> void
+{
+    core::counting_array input{ data };
+
+    core::stats_emitter::reset();
+    g_algorithms.at(s.algorithm).counting(input);
+    auto const counts = core::stats_emitter::counts();
+
+    std::cout << s.algorithm << " on " << data.size() << " elements: " << counts.accesses << " accesses, "
+              << counts.comparisons << " comparisons, " << counts.swaps << " swaps, " << counts.modifies << " modifies"
+              << (input.is_sorted() ? "" : " (NOT SORTED)") << std::endl;
+}
+
+[[nodiscard]] auto external_config(settings const& s) -> core::external_sort_config
+{
+    core::external_sort_config cfg{};
+    cfg.input_path = s.external_path;
+    cfg.output_path = s.external_path + ".sorted";
+    cfg.memory_limit = s.memory_limit;
+    cfg.sort = g_algorithms.at(s.algorithm).silent;
+    return cfg;
+}
+
+// Times an external sort, reading and writing the files included.
+auto external_benchmark(settings const& s) -> void
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const result = core::external_sort(external_config(s));
+    auto const end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> const elapsed = end - start;
+    std::cout << s.algorithm << " on " << result.keys << " keys from " << s.external_path << ": " << elapsed.count()
+              << " ms, " << result.runs << " runs, " << result.merge_passes << " merge passes" << std::endl;
+}
+
+// Stands in for a key file too large to show: every `stride`th key, scaled to the heights the view draws.
+struct external_view
+{
+    std::uint64_t stride{ 1 };
+    core::element_t min{ 0 };
+    core::element_t max{ 0 };
+    core::element_t size{ 0 };
+
+    [[nodiscard]] auto height(core::element_t const key) const noexcept -> core::element_t
+    {
+        if(max <= min) {
+            return size;
+        }
+
+        auto const offset = static_cast<long double>(std::clamp(key, min, max) - min);
+        auto const scale = static_cast<long double>(size - 1) / static_cast<long double>(max - min);
+        return 1 + static_cast<core::element_t>(offset * scale);
+    }
+};
+
+// Samples `s.size` keys of the external input, `data` gets what the view starts with. Keys outside the range of the
+// samples are clamped to it.
+[[nodiscard]] auto sample_external(settings const& s, std::vector<core::element_t>& data) -> external_view
+{
+    auto const samples = core::sample_key_file(s.external_path, s.size);
+
+    if(samples.empty()) {
+        throw std::runtime_error{ "'" + s.external_path + "' has no keys to sort" };
+    }
+
+    external_view view{};
+    view.stride = core::sample_stride_for(core::key_file_size(s.external_path), s.size);
+    view.min = *std::min_element(samples.begin(), samples.end());
+    view.max = *std::max_element(samples.begin(), samples.end());
+    view.size = samples.size();
+
+    data.clear();
+    std::transform(samples.begin(), samples.end(), std::back_inserter(data), [&view](core::element_t const key) {
+        return view.height(key);
+    });
+
+    return view;
+}
+
+// Runs an external sort that shows every key it writes over a sampled one: runs fill in as they are sorted, then
+// every merge sweeps over the runs it merges.
+auto sort_external(settings const& s, external_view const& view) -> void
+{
+    auto cfg = external_config(s);
+    cfg.sample_stride = view.stride;
+    cfg.on_sample = [&view](core::external_phase, std::uint64_t const position, core::element_t const key) {
+        core::normal_emitter::on_modify(position / view.stride, view.height(key));
+    };
+
+    try {
+        [[maybe_unused]] auto const result = core::external_sort(cfg);
+        INFO("Sorted {} keys into {} in {} runs and {} merge passes",
+             result.keys,
+             cfg.output_path,
+             result.runs,
+             result.merge_passes);
+    }
+    catch(std::exception const& e) {
+        ERROR("External sort failed: {}", e.what());
+    }
+
+    core::normal_emitter::on_end();
+    core::normal_emitter::flush();
+}
+
+// Sorts as fast as possible without a window, writing every event to the trace file.
+auto record(settings const& s, std::vector<core::element_t> const& data, std::uint64_t const seed) -> void
+{
+    core::trace_writer writer{ s.record_path, { s.algorithm, seed, data } };
+    auto& ev = core::event_manager::instance();
+
+    core::array input{ data };
+    std::atomic<bool> sorted{ false };
+    std::thread sort_thread{ [&input, &sorted, algo = g_algorithms.at(s.algorithm).visual] {
+        algo(input);
+        core::normal_emitter::flush();
+        sorted.store(true, std::memory_order_release);
+    } };
+
+    constexpr std::size_t words_per_pop = 1U << 16U;
+    std::vector<core::packed_event> words(words_per_pop);
+    std::size_t total_words = 0;
+
+    try {
+        for(;;) {
+            // read the flag first so nothing pushed before it was set can be missed
+            bool const done = sorted.load(std::memory_order_acquire);
+            auto const count = ev.pop_packed(words.data(), words.size());
+
+            writer.write(words.data(), count);
+            total_words += count;
+
+            if(count == 0) {
+                if(done) {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+    }
+    catch(...) {
+        ev.close();
+
+        if(sort_thread.joinable()) {
+            sort_thread.join();
+        }
+        throw;
+    }
+
+    sort_thread.join();
+    std::cout << "Recorded " << s.algorithm << " on " << data.size() << " elements (seed " << seed << "): "
+              << total_words * sizeof(core::packed_event) << " bytes of events in " << s.record_path << std::endl;
+}
+
+auto apply_event(gfx::sort_view& view, core::event_data const& event) -> void
+{
+    switch(event.type) {
+    case core::event_type::access: {
+        TRACE("[Consumer] Accessed #{}", event.i);
+        view.access(event.i, event.lane);
+        break;
+    }
+    case core::event_type::compare: {
+        TRACE("[Consumer] Compared #{} with #{}", event.i, event.j);
+        view.compare(event.i, event.j, event.lane);
+        break;
+    }
+    case core::event_type::modify: {
+        TRACE("[Consumer] Modified #{} with {}", event.i, event.j);
+        view.modify(event.i, event.j, event.lane);
+        break;
+    }
+    case core::event_type::swap: {
+        TRACE("[Consumer] Swapped #{} with #{}", event.i, event.j);
+        view.swap(event.i, event.j, event.lane);
+        break;
+    }
+    case core::event_type::end: {
+        TRACE("[Consumer] Ended sorting");
+        view.end();
+        break;
+    }
+    default: {
+        break;
+    }
     }
 }
 
@@ -148,13 +462,65 @@ auto main(int argc, char* argv[]) noexcept -> int
         auto args =
             docopt::docopt(g_usage, { argv + 1, argv + argc }, /* show help: */ true, "SortVisualizer"); // NOLINT
 
+        constexpr gfx::color red{ 1.0F, 0.0F, 0.0F, 1.0F };
+        constexpr gfx::color dark_red{ 0.5F, 0.0F, 0.0F, 1.0F };
+        constexpr gfx::color green{ 0.0F, 0.8F, 0.0F, 1.0F };
+
+        settings cfg{};
+        cfg.view.type = gfx::view_type::rect;
+        cfg.view.color_type = gfx::color_gradient{ dark_red, red };
+        cfg.view.highlight_color = green;
+
+        configure(args, cfg);
+        core::event_manager::instance().set_max_queued(cfg.max_queued_events);
+        core::normal_emitter::set_coalescing(!cfg.raw_events);
+
+        std::optional<core::trace_reader> replay{};
+        std::optional<external_view> external{};
+        std::vector<core::element_t> data{};
+
+        if(!cfg.replay_path.empty()) {
+            replay.emplace(cfg.replay_path);
+            data = replay->info().initial_data;
+            INFO("Replaying {} on {} elements (seed {})", replay->info().algorithm, data.size(), replay->info().seed);
+        }
+        else if(!cfg.external_path.empty()) {
+            if(cfg.external_keys.has_value()) {
+                core::write_random_keys(cfg.external_path, *cfg.external_keys, cfg.seed.value_or(core::random_seed()));
+            }
+            if(cfg.benchmark) {
+                external_benchmark(cfg);
+                return EXIT_SUCCESS;
+            }
+
+            external = sample_external(cfg, data);
+        }
+        else {
+            auto const seed = cfg.seed.value_or(core::random_seed());
+            data = core::generate_keys(cfg.distribution, cfg.size, seed);
+
+            if(!cfg.record_path.empty()) {
+                record(cfg, data, seed);
+                return EXIT_SUCCESS;
+            }
+            if(cfg.benchmark) {
+                benchmark(cfg, data);
+                return EXIT_SUCCESS;
+            }
+            if(cfg.stats) {
+                stats(cfg, data);
+                return EXIT_SUCCESS;
+            }
+        }
+
         gfx::window wnd{ "SortVisualizer" };
         auto& sound = audio::audio_manager::instance();
 
         bool process_next_event = false;
         bool pause_after_iteration = false;
+        core::playback_clock playback{ cfg.events_per_second };
 
-        wnd.on_key_press([&process_next_event, &pause_after_iteration, &sound](gfx::key_event const ev) {
+        wnd.on_key_press([&process_next_event, &pause_after_iteration, &sound, &playback](gfx::key_event const ev) {
             if(ev == gfx::key_event::right) {
                 TRACE("RIGHT arrow pressed");
                 process_next_event = true;
@@ -164,6 +530,14 @@ auto main(int argc, char* argv[]) noexcept -> int
                 TRACE("SPACE key pressed");
                 process_next_event = !process_next_event;
             }
+            else if(ev == gfx::key_event::up) {
+                playback.faster();
+                INFO("Playing {} events per second", playback.rate());
+            }
+            else if(ev == gfx::key_event::down) {
+                playback.slower();
+                INFO("Playing {} events per second", playback.rate());
+            }
             else if(ev == gfx::key_event::s) {
                 TRACE("'S' key pressed");
                 sound.sound_on() ? sound.turn_sound_off() : sound.turn_sound_on();
@@ -175,77 +549,89 @@ auto main(int argc, char* argv[]) noexcept -> int
         using namespace std::chrono;
         using namespace std::chrono_literals;
 
-        std::chrono::milliseconds delay = 15ms;
-
-        core::element_t data_size = 10; // NOLINT
-        constexpr gfx::color red{ 1.0F, 0.0F, 0.0F, 1.0F };
-        constexpr gfx::color dark_red{ 0.5F, 0.0F, 0.0F, 1.0F };
-        constexpr gfx::color green{ 0.0F, 0.8F, 0.0F, 1.0F };
-
-        gfx::sort_view_config cfg{};
-        cfg.type = gfx::view_type::rect;
-        cfg.color_type = gfx::color_gradient{ dark_red, red };
-        cfg.highlight_color = green;
-
-        algorithm_t algo = &core::algorithm::bubble_sort;
-        double sound_delay = 10.0; // NOLINT
-
-        configure(args, data_size, algo, delay, sound_delay, cfg);
+        sound.set_max(data.size());
+        sound.set_delay(cfg.sound_delay);
 
-        sound.set_max(data_size);
-        sound.set_delay(sound_delay);
-
-        auto const data = generate_data(data_size);
-
-        gfx::sort_view view{ cfg, data };
+        gfx::sort_view view{ cfg.view, data };
 
         core::array input{ data };
-        std::thread sort_thread{ [&input, algo] { algo(input); } };
+        std::thread sort_thread{};
         auto& ev = core::event_manager::instance();
 
-        auto start = steady_clock::now();
+        if(external.has_value()) {
+            sort_thread = std::thread{ [&cfg, view = *external] { sort_external(cfg, view); } };
+        }
+        else if(!replay.has_value()) {
+            sort_thread = std::thread{ [&input, algo = g_algorithms.at(cfg.algorithm).visual] {
+                algo(input);
+                core::normal_emitter::flush();
+            } };
+        }
+
+        auto next_events = [&replay, &ev](core::event_data* const out, std::size_t const max_count) -> std::size_t {
+            return replay.has_value() ? replay->read(out, max_count) : ev.pop(out, max_count);
+        };
+
+        // a frame stops playing events after this long, even if more are due, to keep the window responsive
+        constexpr auto frame_budget = 12ms;
+        constexpr std::size_t events_per_pop = 1'024;
+        std::vector<core::event_data> events(events_per_pop);
 
         while(!wnd.should_close()) {
             wnd.handle_events();
 
-            auto end = steady_clock::now();
-            auto const duration = end - start;
+            auto const frame_start = steady_clock::now();
+            std::size_t due = 0;
 
-            if(process_next_event && duration >= delay && !ev.empty()) {
-                start = end;
-                auto const event = ev.pop();
+            if(pause_after_iteration) {
+                due = 1;
+                playback.reset(frame_start);
+            }
+            else if(process_next_event) {
+                due = playback.advance(frame_start);
+            }
+            else {
+                playback.reset(frame_start);
+            }
 
-                switch(event.type) {
-                case core::event_type::access: {
-                    TRACE("[Consumer] Accessed #{}", event.i);
-                    view.access(event.i);
-                    sound.sound_access(event.j);
-                    break;
-                }
-                case core::event_type::compare: {
-                    TRACE("[Consumer] Compared #{} with #{}", event.i, event.j);
-                    view.compare(event.i, event.j);
-                    break;
-                }
-                case core::event_type::modify: {
-                    TRACE("[Consumer] Modified #{} with {}", event.i, event.j);
-                    view.modify(event.i, event.j);
-                    break;
-                }
-                case core::event_type::swap: {
-                    TRACE("[Consumer] Swapped #{} with #{}", event.i, event.j);
-                    view.swap(event.i, event.j);
-                    break;
-                }
-                case core::event_type::end: {
-                    TRACE("[Consumer] Ended sorting");
-                    view.end();
-                    break;
+            std::size_t played = 0;
+            std::optional<core::element_t> last_accessed_value{};
+
+            while(played < due) {
+                auto const count = next_events(events.data(), std::min(events.size(), due - played));
+
+                for(std::size_t k = 0; k < count; ++k) {
+                    apply_event(view, events[k]);
+
+                    // accesses folded into a compare or swap still get their sound
+                    switch(events[k].type) {
+                    case core::event_type::access: {
+                        last_accessed_value = events[k].j;
+                        break;
+                    }
+                    case core::event_type::compare:
+                    case core::event_type::swap: {
+                        last_accessed_value = view.value(events[k].j);
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                    }
                 }
-                default: {
+
+                played += count;
+
+                if(count == 0 || steady_clock::now() - frame_start >= frame_budget) {
                     break;
                 }
-                }
+            }
+
+            playback.consume(played);
+
+            // one sound per frame, playing every access of a batch would just be noise
+            if(last_accessed_value.has_value()) {
+                sound.sound_access(*last_accessed_value);
             }
 
             if(pause_after_iteration) {
@@ -259,7 +645,11 @@ auto main(int argc, char* argv[]) noexcept -> int
             wnd.swap_buffers();
         }
 
-        sort_thread.join();
+        ev.close();
+
+        if(sort_thread.joinable()) {
+            sort_thread.join();
+        }
 
         sound.quit();
     }
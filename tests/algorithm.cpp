@@ -2,14 +2,27 @@
 #include <doctest/doctest.h>
 
 #include "algorithm/algorithm.hpp"
+#include "algorithm/distribution.hpp"
+#include "algorithm/histogram.hpp"
+#include "algorithm/loser_tree.hpp"
 #include "algorithm/random.hpp"
+#include "algorithm/sorting_network.hpp"
+#include "algorithm/task_pool.hpp"
 #include "event/event.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <numeric>
 #include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 template<std::size_t N>
@@ -91,6 +104,48 @@ TEST_CASE("[Algorithm] Bubble Sort")
     }
 }
 
+TEST_CASE("[Algorithm] Count Sort on any key range")
+{
+    std::mt19937_64 rng{ 11 };
+    std::vector<std::vector<core::element_t>> inputs;
+
+    // dense keys far from zero
+    inputs.emplace_back(sort_data::for_size(1'000));
+    std::transform(inputs.back().begin(), inputs.back().end(), inputs.back().begin(), [](auto const key) {
+        return key + (core::element_t{ 1 } << 50U);
+    });
+    // a few keys spread over the whole range, counting them would take gigabytes
+    inputs.emplace_back(10'000);
+    std::generate(inputs.back().begin(), inputs.back().end(), [&rng] { return rng(); });
+    inputs.back().front() = 0;
+    inputs.back().back() = ~core::element_t{ 0 };
+    // keys larger than the array is long, but close enough to count
+    inputs.emplace_back(10'000);
+    std::generate(inputs.back().begin(), inputs.back().end(), [&rng] { return 1'000'000 + rng() % 20'000; });
+    // a single key
+    inputs.emplace_back(100, 42);
+
+    for(auto const& input : inputs) {
+        auto expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ input };
+        core::algorithm::count_sort(data);
+
+        core::silent_array silent{ input };
+        core::algorithm::count_sort(silent);
+
+        for(std::size_t i = 0; i < input.size(); ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+            REQUIRE(silent[i].get_raw() == expected[i]);
+        }
+    }
+
+    core::array empty{ std::vector<core::element_t>{} };
+    core::algorithm::count_sort(empty);
+    REQUIRE(empty.size() == 0);
+}
+
 TEST_CASE("[Algorithm] Insertion Sort")
 {
     auto const sizes = to_array({ 5, 10, 100, 250 });
@@ -124,6 +179,36 @@ TEST_CASE("[Algorithm] Simple Radix Sort")
     }
 }
 
+TEST_CASE("[Algorithm] American Flag Sort")
+{
+    auto const sizes = to_array({ 5, 10, 100, 250, 1'000, 5'000, 10'000, 100'000 });
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::american_flag_sort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    // keys that use every byte, with a few repeated ones
+    std::mt19937_64 rng{ 7 };
+    std::vector<core::element_t> keys(100'000);
+    std::generate(keys.begin(), keys.end(), [&rng] { return (rng() % 8 == 0) ? 42 : rng(); });
+
+    core::array data{ keys };
+    core::algorithm::american_flag_sort(data);
+    std::sort(keys.begin(), keys.end());
+
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(data[i].get_raw() == keys[i]);
+    }
+}
+
 TEST_CASE("[Algorithm] QuickSort")
 {
     auto const sizes = to_array({ 5, 10, 100, 250, 1'000, 5'000, 10'000 });
@@ -135,6 +220,92 @@ TEST_CASE("[Algorithm] QuickSort")
     }
 }
 
+TEST_CASE("[Algorithm] PdqSort")
+{
+    constexpr core::element_t size = 100'003;
+
+    auto const sizes = to_array({ 5, 10, 100, 250, 1'000, 5'000, 10'000 });
+
+    for(auto const n : sizes) {
+        core::array data{ sort_data::for_size(n) };
+        core::algorithm::pdqsort(data);
+        REQUIRE(data.is_sorted());
+    }
+
+    std::vector<std::vector<core::element_t>> inputs(6, std::vector<core::element_t>(size));
+
+    for(core::element_t i = 0; i < size; ++i) {
+        inputs[0][i] = i;                       // sorted
+        inputs[1][i] = size - i;                // reversed
+        inputs[2][i] = i % 4;                   // few unique
+        inputs[3][i] = std::min(i, size - i);   // organ pipe
+        inputs[4][i] = i % 1'000;               // sawtooth
+        inputs[5][i] = (i == size / 2) ? 0 : i; // sorted but one
+    }
+
+    inputs.push_back(sort_data::for_size(size));
+
+    for(auto const& input : inputs) {
+        auto expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ input };
+        core::algorithm::pdqsort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("[Algorithm] HeapSort")
+{
+    // sizes around full levels of binary, 4-ary and 8-ary heaps
+    auto const sizes = to_array({ 5, 10, 64, 73, 100, 250, 1'000, 5'000, 10'000 });
+
+    for(auto const algorithm : { &core::algorithm::heap_sort<core::array>,
+                                 &core::algorithm::heap_sort_4ary<core::array>,
+                                 &core::algorithm::heap_sort_8ary<core::array>,
+                                 &core::algorithm::heap_sort_bottom_up<core::array> }) {
+        for(auto const size : sizes) {
+            auto expected = sort_data::for_size(size);
+            std::sort(expected.begin(), expected.end());
+
+            core::array data{ sort_data::for_size(size) };
+            algorithm(data);
+
+            for(core::element_t i = 0; i < size; ++i) {
+                REQUIRE(data[i].get_raw() == expected[i]);
+            }
+        }
+
+        std::vector<core::element_t> few_unique(1'000);
+        std::generate(few_unique.begin(), few_unique.end(), [i = 0U]() mutable { return i++ % 3; });
+
+        core::array data{ few_unique };
+        algorithm(data);
+        REQUIRE(data.is_sorted());
+    }
+}
+
+TEST_CASE("[Algorithm] Bottom-up HeapSort compares less")
+{
+    auto const& input = sort_data::for_size(10'000);
+
+    core::counting_array binary{ input };
+    core::stats_emitter::reset();
+    core::algorithm::heap_sort(binary);
+    auto const binary_comparisons = core::stats_emitter::counts().comparisons;
+
+    core::counting_array bottom_up{ input };
+    core::stats_emitter::reset();
+    core::algorithm::heap_sort_bottom_up(bottom_up);
+    auto const bottom_up_comparisons = core::stats_emitter::counts().comparisons;
+
+    REQUIRE(bottom_up.is_sorted());
+    REQUIRE(bottom_up_comparisons < binary_comparisons * 3 / 4);
+}
+
 TEST_CASE("[Algorithm] MergeSort")
 {
     auto const sizes = to_array({ 5, 10, 100, 250, 1'000, 5'000, 10'000 });
@@ -145,3 +316,858 @@ TEST_CASE("[Algorithm] MergeSort")
         REQUIRE(data.is_sorted());
     }
 }
+
+TEST_CASE("[Algorithm] Bottom-up MergeSort")
+{
+    // sizes off powers of two leave short last runs, some take an odd number of passes
+    auto const sizes = to_array({ 5, 10, 32, 33, 100, 250, 1'000, 5'000, 10'000, 100'003 });
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::merge_sort_bottom_up(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("[Algorithm] Multiway MergeSort")
+{
+    // one pass, two passes ending in the buffer, groups with a single run left over
+    auto const sizes = to_array({ 5, 32, 33, 100, 2'048, 2'049, 5'000, 100'003, 300'000 });
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::multiway_merge_sort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("[Algorithm] Multiway MergeSort writes less")
+{
+    auto const& input = sort_data::for_size(100'003);
+
+    core::counting_array binary{ input };
+    core::stats_emitter::reset();
+    core::algorithm::merge_sort_bottom_up(binary);
+    auto const binary_writes = core::stats_emitter::counts().modifies;
+
+    core::counting_array multiway{ input };
+    core::stats_emitter::reset();
+    core::algorithm::multiway_merge_sort(multiway);
+    auto const multiway_writes = core::stats_emitter::counts().modifies;
+
+    REQUIRE(multiway.is_sorted());
+    REQUIRE(multiway_writes < binary_writes / 2);
+}
+
+TEST_CASE("[Algorithm] Loser tree")
+{
+    // sources 1 and 3 are left out, ties go to the lower source
+    std::vector<std::vector<int>> const sources{ { 1, 4, 4, 9 }, {}, { 0, 4, 5 }, {}, { 2, 3 } };
+    core::loser_tree<int> tree{ sources.size() };
+    std::vector<std::size_t> next(sources.size(), 0);
+
+    for(std::size_t s = 0; s < sources.size(); ++s) {
+        if(!sources[s].empty()) {
+            tree.set(s, sources[s][0]);
+        }
+    }
+
+    tree.build();
+
+    std::vector<std::pair<int, std::size_t>> merged{};
+
+    while(!tree.empty()) {
+        auto const s = tree.top_source();
+        merged.emplace_back(tree.top(), s);
+
+        if(++next[s] < sources[s].size()) {
+            tree.replace_top(sources[s][next[s]]);
+        }
+        else {
+            tree.pop_top();
+        }
+    }
+
+    REQUIRE(merged == std::vector<std::pair<int, std::size_t>>{
+                          { 0, 2 }, { 1, 0 }, { 2, 4 }, { 3, 4 }, { 4, 0 }, { 4, 0 }, { 4, 2 }, { 5, 2 }, { 9, 0 } });
+
+    tree.clear();
+    tree.build();
+    REQUIRE(tree.empty());
+}
+
+TEST_CASE("[Algorithm] Sorting Network")
+{
+    auto const sizes = to_array({ 5, 10, 32, 33, 100, 250, 1'000 });
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::sorting_network(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("[SortingNetwork] Every network sorts all inputs of zeros and ones")
+{
+    // a network that sorts every 0-1 input sorts every input
+    static_assert(core::network<8>.size() == 19);
+    static_assert(core::network<10>.size() == 29);
+    static_assert(core::network<16>.size() == 60);
+    static_assert(core::network<32>.size() == 185);
+
+    constexpr std::size_t max_exhaustive = 16;
+
+    for(std::size_t n = 0; n <= max_exhaustive; ++n) {
+        for(std::size_t bits = 0; bits < (std::size_t{ 1 } << n); ++bits) {
+            std::array<core::element_t, max_exhaustive> keys{};
+
+            for(std::size_t i = 0; i < n; ++i) {
+                keys[i] = (bits >> i) & 1U;
+            }
+
+            core::network_sort(keys.data(), n);
+            REQUIRE(std::is_sorted(keys.begin(), keys.begin() + std::ptrdiff_t(n)));
+        }
+    }
+
+    std::mt19937_64 rng{ 42 };
+
+    for(std::size_t n = max_exhaustive + 1; n <= core::max_network_size; ++n) {
+        for(int round = 0; round < 1'000; ++round) {
+            std::array<core::element_t, core::max_network_size> keys{};
+            std::generate(keys.begin(), keys.begin() + std::ptrdiff_t(n), [&rng] { return rng() % 8; });
+
+            core::network_sort(keys.data(), n);
+            REQUIRE(std::is_sorted(keys.begin(), keys.begin() + std::ptrdiff_t(n)));
+        }
+    }
+}
+
+TEST_CASE("[SortingNetwork] The kernels sort every key type")
+{
+    std::mt19937_64 rng{ 7 };
+
+    for(std::size_t n = 0; n <= core::max_network_size; ++n) {
+        std::array<float, core::max_network_size> floats{};
+        std::array<std::int32_t, core::max_network_size> ints{};
+        std::array<core::key_value, core::max_network_size> records{};
+
+        for(std::size_t i = 0; i < n; ++i) {
+            floats.at(i) = float(std::int64_t(rng() % 201) - 100) / 4.0F;
+            ints.at(i) = std::int32_t(rng());
+            records.at(i) = { std::uint32_t(rng() % 8), std::uint32_t(i) };
+        }
+
+        core::network_sort(floats.data(), n);
+        core::network_sort(ints.data(), n);
+        core::network_sort(records.data(), n);
+
+        auto const end = std::ptrdiff_t(n);
+        REQUIRE(std::is_sorted(floats.begin(), floats.begin() + end));
+        REQUIRE(std::is_sorted(ints.begin(), ints.begin() + end));
+        REQUIRE(std::is_sorted(records.begin(), records.begin() + end));
+    }
+}
+
+TEST_CASE("[SortingNetwork] Silent arrays sort their leaves with the kernels")
+{
+    auto const sizes = to_array({ 2, 15, 16, 17, 31, 32, 33, 1'000, 10'000 });
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        for(auto const algorithm : { &core::algorithm::quicksort<core::silent_array>,
+                                     &core::algorithm::merge_sort<core::silent_array>,
+                                     &core::algorithm::merge_sort_bottom_up<core::silent_array>,
+                                     &core::algorithm::multiway_merge_sort<core::silent_array>,
+                                     &core::algorithm::american_flag_sort<core::silent_array> }) {
+            core::silent_array data{ sort_data::for_size(size) };
+            algorithm(data);
+
+            for(core::element_t i = 0; i < size; ++i) {
+                REQUIRE(data[i].get_raw() == expected[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("[Algorithm] TimSort")
+{
+    constexpr core::element_t size = 100'003;
+
+    auto const sizes = to_array({ 5, 10, 31, 100, 250, 1'000, 5'000, 10'000 });
+
+    for(auto const n : sizes) {
+        core::array data{ sort_data::for_size(n) };
+        core::algorithm::timsort(data);
+        REQUIRE(data.is_sorted());
+    }
+
+    std::vector<std::vector<core::element_t>> inputs(5, std::vector<core::element_t>(size));
+
+    for(core::element_t i = 0; i < size; ++i) {
+        inputs[0][i] = i;                            // sorted
+        inputs[1][i] = size - i;                     // reversed
+        inputs[2][i] = i % 4;                        // few unique
+        inputs[3][i] = (i % 2 == 0) ? i : size + i;  // two interleaved runs
+        inputs[4][i] = (i / 1'000 % 2 == 0) ? i : 0; // sorted blocks between constant ones
+    }
+
+    inputs.push_back(sort_data::for_size(size));
+
+    for(auto const& input : inputs) {
+        auto expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ input };
+        core::algorithm::timsort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    // finding the runs reads every element twice, merging them with galloping a few more times
+    std::vector<core::element_t> two_runs(size);
+    std::iota(two_runs.begin(), two_runs.end(), 0);
+    std::rotate(two_runs.begin(), two_runs.begin() + size / 3, two_runs.end());
+
+    for(auto const& input : { inputs[0], inputs[1], two_runs }) {
+        core::counting_array data{ input };
+
+        core::stats_emitter::reset();
+        core::algorithm::timsort(data);
+
+        REQUIRE(data.is_sorted());
+        REQUIRE(core::stats_emitter::counts().accesses < 6 * size);
+    }
+}
+
+TEST_CASE("[Algorithm] Parallel MergeSort")
+{
+    auto const sizes = to_array({ 5, 10, 1'000, 10'000, 100'000, 300'001 });
+
+    core::task_pool pool{ 3 };
+    core::task_pool::set_instance(&pool);
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::parallel_merge_sort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    core::task_pool::set_instance(nullptr);
+}
+
+TEST_CASE("[Algorithm] Parallel QuickSort")
+{
+    // the largest size is partitioned in parallel
+    auto const sizes = to_array({ 5, 10, 1'000, 10'000, 100'000, 1'500'000 });
+
+    core::task_pool pool{ 3 };
+    core::task_pool::set_instance(&pool);
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::parallel_quicksort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    std::vector<core::element_t> few_values(1'500'000);
+
+    for(std::size_t i = 0; i < few_values.size(); ++i) {
+        few_values[i] = i % 3;
+    }
+
+    core::array data{ few_values };
+    core::algorithm::parallel_quicksort(data);
+    REQUIRE(data.is_sorted());
+
+    core::task_pool::set_instance(nullptr);
+}
+
+TEST_CASE("[Algorithm] Samplesort")
+{
+    // the larger sizes take a few levels of distribution, with stripes for every thread
+    auto const sizes = to_array({ 5, 10, 1'000, 4'097, 10'000, 100'000, 1'500'000 });
+
+    core::task_pool pool{ 3 };
+    core::task_pool::set_instance(&pool);
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::samplesort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    // few distinct keys go to equality buckets, sorted input keeps every bucket in place
+    std::vector<core::element_t> few_values(1'500'000);
+    std::vector<core::element_t> ascending(1'500'000);
+
+    for(std::size_t i = 0; i < few_values.size(); ++i) {
+        few_values[i] = i % 3;
+        ascending[i] = i;
+    }
+
+    for(auto const& input : { few_values, ascending }) {
+        core::array data{ input };
+        core::algorithm::samplesort(data);
+        REQUIRE(data.is_sorted());
+    }
+
+    core::task_pool::set_instance(nullptr);
+}
+
+TEST_CASE("[Algorithm] Parallel Radix Sort")
+{
+    auto const sizes = to_array({ 5, 10, 1'000, 10'000, 100'000, 300'001 });
+
+    core::task_pool pool{ 3 };
+    core::task_pool::set_instance(&pool);
+
+    for(auto const size : sizes) {
+        auto expected = sort_data::for_size(size);
+        std::sort(expected.begin(), expected.end());
+
+        core::array data{ sort_data::for_size(size) };
+        core::algorithm::parallel_radix_sort(data);
+
+        for(core::element_t i = 0; i < size; ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+
+    // keys that use every byte
+    std::mt19937_64 rng{ 42 };
+    std::vector<core::element_t> wide_keys(100'000);
+    std::generate(wide_keys.begin(), wide_keys.end(), rng);
+
+    core::array data{ wide_keys };
+    core::algorithm::parallel_radix_sort(data);
+    std::sort(wide_keys.begin(), wide_keys.end());
+
+    for(std::size_t i = 0; i < wide_keys.size(); ++i) {
+        REQUIRE(data[i].get_raw() == wide_keys[i]);
+    }
+
+    core::task_pool::set_instance(nullptr);
+}
+
+TEST_CASE("[Algorithm] Events of a parallel sort replay to the sorted result")
+{
+    constexpr core::element_t size = 50'000;
+    using visual_array = core::basic_array<core::normal_emitter>;
+
+    auto const& input = sort_data::for_size(size);
+    auto const sorts = { &core::algorithm::parallel_merge_sort<visual_array>,
+                         &core::algorithm::parallel_quicksort<visual_array>,
+                         &core::algorithm::samplesort<visual_array>,
+                         &core::algorithm::parallel_radix_sort<visual_array> };
+
+    // the default pool may have no workers on a small machine, this one has a lane per worker at least
+    core::task_pool pool{ 3 };
+    core::task_pool::set_instance(&pool);
+
+    for(auto* const sort : sorts) {
+        visual_array data{ input };
+        std::thread sort_thread{ [&data, sort] { sort(data); } };
+
+        auto& mng = core::event_manager::instance();
+        std::vector<core::element_t> replayed = input;
+        std::array<core::event_data, 1'024> events{};
+        bool ended = false;
+
+        while(!ended) {
+            auto const n = mng.pop(events.data(), events.size());
+
+            for(std::size_t k = 0; k < n; ++k) {
+                auto const& ev = events.at(k);
+
+                if(ev.type == core::event_type::modify) {
+                    replayed[ev.i] = ev.j;
+                }
+                else if(ev.type == core::event_type::swap) {
+                    std::swap(replayed[ev.i], replayed[ev.j]);
+                }
+
+                ended = ended || ev.type == core::event_type::end;
+            }
+
+            if(n == 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        sort_thread.join();
+
+        REQUIRE(data.is_sorted());
+        REQUIRE(std::is_sorted(replayed.begin(), replayed.end()));
+        REQUIRE(mng.empty());
+    }
+
+    core::task_pool::set_instance(nullptr);
+}
+
+template<typename Key>
+auto check_every_algorithm(std::vector<Key> const& input) -> void
+{
+    using array_t = core::silent_array_of<Key>;
+
+    auto expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    for(auto const algorithm : { &core::algorithm::count_sort<array_t>,
+                                 &core::algorithm::radix_sort<array_t>,
+                                 &core::algorithm::radix_sort_simple<array_t>,
+                                 &core::algorithm::parallel_radix_sort<array_t>,
+                                 &core::algorithm::american_flag_sort<array_t>,
+                                 &core::algorithm::quicksort<array_t>,
+                                 &core::algorithm::parallel_quicksort<array_t>,
+                                 &core::algorithm::samplesort<array_t>,
+                                 &core::algorithm::pdqsort<array_t>,
+                                 &core::algorithm::merge_sort<array_t>,
+                                 &core::algorithm::merge_sort_bottom_up<array_t>,
+                                 &core::algorithm::multiway_merge_sort<array_t>,
+                                 &core::algorithm::timsort<array_t>,
+                                 &core::algorithm::parallel_merge_sort<array_t>,
+                                 &core::algorithm::heap_sort<array_t>,
+                                 &core::algorithm::heap_sort_4ary<array_t>,
+                                 &core::algorithm::heap_sort_8ary<array_t>,
+                                 &core::algorithm::heap_sort_bottom_up<array_t>,
+                                 &core::algorithm::sorting_network<array_t> }) {
+        array_t data{ input };
+        algorithm(data);
+
+        for(std::size_t i = 0; i < input.size(); ++i) {
+            REQUIRE(data[i].get_raw() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("[Algorithm] Other key types")
+{
+    constexpr std::size_t size = 20'000;
+
+    std::mt19937_64 rng{ 3 };
+    std::uniform_real_distribution<double> real{ -1e6, 1e6 };
+
+    std::vector<std::uint32_t> u32(size);
+    std::vector<std::int32_t> i32(size);
+    std::vector<std::int64_t> i64(size);
+    std::vector<float> f32(size);
+    std::vector<double> f64(size);
+
+    for(std::size_t i = 0; i < size; ++i) {
+        auto const bits = rng();
+        u32[i] = static_cast<std::uint32_t>(bits);
+        i32[i] = static_cast<std::int32_t>(bits % 2'001) - 1'000; // dense, so count_sort counts them
+        i64[i] = static_cast<std::int64_t>(bits);
+        f32[i] = static_cast<float>(real(rng));
+        f64[i] = real(rng);
+    }
+
+    // the radix bits keep zeros, infinities and the extremes in order
+    f64[0] = -0.0;
+    f64[1] = 0.0;
+    f64[2] = std::numeric_limits<double>::infinity();
+    f64[3] = -std::numeric_limits<double>::infinity();
+    f64[4] = std::numeric_limits<double>::lowest();
+    i64[0] = std::numeric_limits<std::int64_t>::min();
+    i64[1] = std::numeric_limits<std::int64_t>::max();
+
+    check_every_algorithm(u32);
+    check_every_algorithm(i32);
+    check_every_algorithm(i64);
+    check_every_algorithm(f32);
+    check_every_algorithm(f64);
+
+    for(auto const key : { -2.5, -0.0, 0.0, 1e-300, 3.0 }) {
+        REQUIRE(core::key_traits<double>::from_bits(core::radix_key(key)) == key);
+    }
+}
+
+TEST_CASE("[Algorithm] Every algorithm on every distribution")
+{
+    for(auto const distribution : core::g_distributions) {
+        std::string const name{ core::distribution_name(distribution) };
+        CAPTURE(name);
+
+        for(core::element_t const size : { 1U, 33U, 10'007U }) {
+            check_every_algorithm(core::generate_keys(distribution, size, 11));
+        }
+    }
+}
+
+TEST_CASE("[Distribution] Shapes, ranges and seeds")
+{
+    // spans a few generator blocks, the last one short
+    constexpr core::element_t size = 200'003;
+
+    for(auto const distribution : core::g_distributions) {
+        std::string const name{ core::distribution_name(distribution) };
+        CAPTURE(name);
+        REQUIRE(core::parse_distribution(core::distribution_name(distribution)) == distribution);
+
+        auto const keys = core::generate_keys(distribution, size, 3);
+        REQUIRE(keys.size() == size);
+        REQUIRE(*std::min_element(keys.begin(), keys.end()) >= 1);
+        REQUIRE(*std::max_element(keys.begin(), keys.end()) <= size);
+
+        // the blocks come out the same however many threads generate them
+        core::task_pool pool{ 0 };
+        core::task_pool::set_instance(&pool);
+        auto const single_thread = core::generate_keys(distribution, size, 3);
+        core::task_pool::set_instance(nullptr);
+        REQUIRE(single_thread == keys);
+
+        REQUIRE(core::generate_keys(distribution, 0, 3).empty());
+        REQUIRE(core::generate_keys(distribution, 1, 3) == std::vector<core::element_t>{ 1 });
+    }
+
+    REQUIRE_FALSE(core::parse_distribution("bogus").has_value());
+
+    auto const keys_of = [](core::distribution const d) { return core::generate_keys(d, size, 3); };
+    auto const distinct = [](std::vector<core::element_t> const& keys) {
+        return std::set<core::element_t>(keys.begin(), keys.end()).size();
+    };
+
+    auto shuffled = keys_of(core::distribution::shuffled);
+    REQUIRE(shuffled != core::generate_keys(core::distribution::shuffled, size, 4));
+    std::sort(shuffled.begin(), shuffled.end());
+    REQUIRE(shuffled == keys_of(core::distribution::sorted));
+
+    auto const reversed = keys_of(core::distribution::reversed);
+    REQUIRE(std::is_sorted(reversed.rbegin(), reversed.rend()));
+    REQUIRE(distinct(reversed) == size);
+
+    // every swap moves at most two keys
+    auto const nearly_sorted = keys_of(core::distribution::nearly_sorted);
+    auto const displaced = core::element_t(std::count_if(
+        nearly_sorted.begin(), nearly_sorted.end(), [i = 0U](auto const key) mutable { return key != ++i; }));
+    REQUIRE(displaced > 0);
+    REQUIRE(displaced <= 2 * size / 100);
+
+    REQUIRE(distinct(keys_of(core::distribution::few_unique)) == 16);
+    REQUIRE(distinct(keys_of(core::distribution::all_equal)) == 1);
+
+    auto const sawtooth = keys_of(core::distribution::sawtooth);
+    REQUIRE(std::is_sorted(sawtooth.begin(), sawtooth.begin() + size / 16));
+    REQUIRE(sawtooth[(size + 15) / 16] == 1);
+
+    auto const organ_pipe = keys_of(core::distribution::organ_pipe);
+    auto const peak = std::max_element(organ_pipe.begin(), organ_pipe.end());
+    REQUIRE(std::is_sorted(organ_pipe.begin(), peak + 1));
+    REQUIRE(std::is_sorted(std::make_reverse_iterator(organ_pipe.end()), std::make_reverse_iterator(peak)));
+
+    // key 1 comes up about twice as often as key 2, and far more often than large keys
+    auto const zipf = keys_of(core::distribution::zipf);
+    auto const ones = std::count(zipf.begin(), zipf.end(), 1U);
+    auto const twos = std::count(zipf.begin(), zipf.end(), 2U);
+    REQUIRE(ones > twos * 3 / 2);
+    REQUIRE(ones < twos * 5 / 2);
+    auto const large =
+        core::element_t(std::count_if(zipf.begin(), zipf.end(), [](auto const key) { return key > size / 2; }));
+    REQUIRE(large < size / 10);
+
+    // about 95% within two standard deviations
+    auto const gaussian = keys_of(core::distribution::gaussian);
+    auto const near_middle = core::element_t(std::count_if(gaussian.begin(), gaussian.end(), [](auto const key) {
+        return key > size / 4 && key < size / 4 * 3;
+    }));
+    REQUIRE(near_middle > size * 9 / 10);
+
+    // the first block draws from the second sixteenth of the keys, the last block from the second to last
+    auto const staggered = keys_of(core::distribution::staggered);
+    auto const within = [](core::element_t const range) {
+        return [range](auto const key) { return key > range * size / 16 && key <= (range + 1) * size / 16; };
+    };
+    REQUIRE(std::all_of(staggered.begin(), staggered.begin() + size / 16, within(1)));
+    REQUIRE(std::all_of(staggered.end() - size / 16, staggered.end(), within(14)));
+}
+
+TEST_CASE("[Algorithm] Stable algorithms keep equal keys in order")
+{
+    using array_t = core::silent_array_of<core::key_value>;
+
+    // few distinct keys, payloads numbering the records in input order
+    std::mt19937_64 rng{ 5 };
+    std::vector<core::key_value> input(10'000);
+
+    for(std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = core::key_value{ static_cast<std::uint32_t>(rng() % 16), static_cast<std::uint32_t>(i) };
+    }
+
+    auto expected = input;
+    std::stable_sort(expected.begin(), expected.end());
+
+    for(auto const algorithm : { &core::algorithm::insertion_sort<array_t>,
+                                 &core::algorithm::radix_sort<array_t>,
+                                 &core::algorithm::radix_sort_simple<array_t>,
+                                 &core::algorithm::parallel_radix_sort<array_t>,
+                                 &core::algorithm::merge_sort<array_t>,
+                                 &core::algorithm::merge_sort_bottom_up<array_t>,
+                                 &core::algorithm::multiway_merge_sort<array_t>,
+                                 &core::algorithm::timsort<array_t>,
+                                 &core::algorithm::parallel_merge_sort<array_t> }) {
+        array_t data{ input };
+        algorithm(data);
+
+        for(std::size_t i = 0; i < input.size(); ++i) {
+            REQUIRE(data[i].get_raw().key == expected[i].key);
+            REQUIRE(data[i].get_raw().payload == expected[i].payload);
+        }
+    }
+
+    // the unstable ones still order the keys
+    for(auto const algorithm : { &core::algorithm::pdqsort<array_t>,
+                                 &core::algorithm::parallel_quicksort<array_t>,
+                                 &core::algorithm::samplesort<array_t>,
+                                 &core::algorithm::american_flag_sort<array_t>,
+                                 &core::algorithm::heap_sort_8ary<array_t> }) {
+        array_t data{ input };
+        algorithm(data);
+
+        for(std::size_t i = 0; i < input.size(); ++i) {
+            REQUIRE(data[i].get_raw().key == expected[i].key);
+        }
+    }
+}
+
+TEST_CASE("[Histogram] Every SIMD level counts the same")
+{
+    // an odd count leaves a tail for the scalar code, the repeated keys make the kernels merge increments
+    std::vector<core::element_t> keys(10'007);
+
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = (i % 5 == 0) ? (i * 0x9E3779B97F4A7C15U) % keys.size() : 7;
+    }
+
+    core::silent_array const array{ keys };
+
+    // the same keys far from zero, counted from their smallest possible value
+    constexpr core::element_t base = core::element_t{ 1 } << 40U;
+    std::vector<core::element_t> shifted_keys(keys.size());
+    std::transform(keys.begin(), keys.end(), shifted_keys.begin(), [](auto const key) { return key + base; });
+    core::silent_array const shifted{ shifted_keys };
+
+    for(auto const level : { core::simd_level::scalar, core::simd_level::sse4, core::simd_level::avx2 }) {
+        core::set_simd_level(level);
+
+        for(core::element_t byte = 0; byte < 2; ++byte) {
+            core::radix_histogram expected{};
+            core::radix_histogram packed{};
+            core::radix_histogram values{};
+
+            for(auto const key : keys) {
+                ++expected.at((key >> (byte * 8)) & 0xFF);
+            }
+
+            core::byte_histogram(keys.data(), keys.size(), byte, packed);
+            core::byte_histogram(array.data(), array.size(), byte, values);
+
+            REQUIRE(packed == expected);
+            REQUIRE(values == expected);
+        }
+
+        std::vector<core::element_t> expected(keys.size(), 0);
+        std::vector<core::element_t> counts(keys.size(), 0);
+
+        for(auto const key : keys) {
+            ++expected[key];
+        }
+
+        core::value_histogram(array.data(), array.size(), 0, counts.data());
+        REQUIRE(counts == expected);
+
+        std::vector<core::element_t> packed_counts(keys.size(), 0);
+        core::value_histogram(keys.data(), keys.size(), 0, packed_counts.data());
+        REQUIRE(packed_counts == expected);
+
+        std::vector<core::element_t> shifted_counts(keys.size(), 0);
+        core::value_histogram(shifted.data(), shifted.size(), base, shifted_counts.data());
+        REQUIRE(shifted_counts == expected);
+
+        REQUIRE(core::key_range(shifted.data(), shifted.size()) ==
+                std::pair{ *std::min_element(shifted_keys.begin(), shifted_keys.end()),
+                           *std::max_element(shifted_keys.begin(), shifted_keys.end()) });
+    }
+
+    core::set_simd_level(core::supported_simd_level());
+}
+
+TEST_CASE("[TaskPool] Nested groups run every task")
+{
+    core::task_pool pool{ 3 };
+    std::atomic<int> count{ 0 };
+
+    core::task_group outer{ pool };
+
+    for(int i = 0; i < 16; ++i) {
+        outer.run([&pool, &count] {
+            core::task_group inner{ pool };
+
+            for(int j = 0; j < 16; ++j) {
+                inner.run([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+            }
+
+            inner.wait();
+        });
+    }
+
+    outer.wait();
+    REQUIRE(count.load() == 16 * 16);
+}
+
+TEST_CASE("[TaskPool] A throwing task reaches wait")
+{
+    core::task_pool pool{ 3 };
+    std::atomic<int> count{ 0 };
+
+    core::task_group group{ pool };
+
+    for(int i = 0; i < 64; ++i) {
+        group.run([&count, i] {
+            if(i % 16 == 0) {
+                throw std::runtime_error{ "task failed" };
+            }
+
+            count.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    bool thrown = false;
+
+    try {
+        group.wait();
+    }
+    catch(std::runtime_error const&) {
+        thrown = true;
+    }
+
+    REQUIRE(thrown);
+    REQUIRE(count.load() == 60);
+
+    // the group can be reused once its exception was rethrown
+    group.run([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+    group.wait();
+    REQUIRE(count.load() == 61);
+}
+
+TEST_CASE("[Algorithm] Operation statistics")
+{
+    constexpr core::element_t size = 100;
+    constexpr std::uint64_t pairs = size * (size - 1) / 2;
+
+    std::vector<core::element_t> values(size);
+    std::iota(values.begin(), values.end(), 1);
+
+    SUBCASE("Sorted input only compares neighbours once")
+    {
+        core::counting_array data{ values };
+
+        core::stats_emitter::reset();
+        core::algorithm::bubble_sort(data);
+
+        auto const counts = core::stats_emitter::counts();
+        REQUIRE(counts.comparisons == size - 1);
+        REQUIRE(counts.accesses == 2 * (size - 1));
+        REQUIRE(counts.swaps == 0);
+        REQUIRE(counts.modifies == 0);
+    }
+
+    SUBCASE("Reversed input swaps every pair")
+    {
+        core::counting_array data{ std::vector<core::element_t>(values.rbegin(), values.rend()) };
+
+        core::stats_emitter::reset();
+        core::algorithm::bubble_sort(data);
+
+        REQUIRE(data.is_sorted());
+        REQUIRE(core::stats_emitter::counts().comparisons == pairs);
+        REQUIRE(core::stats_emitter::counts().swaps == pairs);
+    }
+
+    SUBCASE("The multiway merge counts its comparisons")
+    {
+        // the leaf sorted runs of 32 keys take turns in the merge
+        std::vector<core::element_t> interleaved(size);
+
+        for(std::size_t i = 0; i < size; ++i) {
+            interleaved[i] = (i % 32) * 4 + i / 32;
+        }
+
+        std::uint64_t leaf_comparisons = 0;
+
+        // up to 32 elements are only leaf sorted
+        for(std::size_t begin = 0; begin < size; begin += 32) {
+            auto const first = interleaved.begin() + static_cast<std::ptrdiff_t>(begin);
+            core::counting_array leaf{ std::vector<core::element_t>(
+                first, first + static_cast<std::ptrdiff_t>(std::min<std::size_t>(32, size - begin))) };
+
+            core::stats_emitter::reset();
+            core::algorithm::multiway_merge_sort(leaf);
+            leaf_comparisons += core::stats_emitter::counts().comparisons;
+        }
+
+        core::counting_array data{ interleaved };
+
+        core::stats_emitter::reset();
+        core::algorithm::multiway_merge_sort(data);
+
+        REQUIRE(data.is_sorted());
+        REQUIRE(core::stats_emitter::counts().comparisons - leaf_comparisons > size);
+    }
+
+    SUBCASE("Counts of finished threads are kept")
+    {
+        core::stats_emitter::reset();
+
+        std::thread worker{ [&values] {
+            core::counting_array data{ values };
+            core::algorithm::bubble_sort(data);
+        } };
+        worker.join();
+
+        core::counting_array data{ values };
+        core::algorithm::bubble_sort(data);
+
+        REQUIRE(core::stats_emitter::counts().comparisons == 2 * (size - 1));
+    }
+}
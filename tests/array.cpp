@@ -3,6 +3,8 @@
 
 #include "event/event.hpp"
 
+#include <vector>
+
 TEST_CASE("[Array] Array value")
 {
     core::array_value v1{ 0 };
@@ -26,3 +28,58 @@ TEST_CASE("[Array] Array value")
     REQUIRE(v2.index() == 2);
     REQUIRE(v3.index() == 3);
 }
+
+TEST_CASE("[Array] The emitter policy decides whether events are emitted")
+{
+    auto& mng = core::event_manager::instance();
+
+    core::silent_array silent{ { 3, 1, 2 } };
+    REQUIRE(silent[0] > silent[1]);
+    silent.swap_at(0, 1);
+    silent.end();
+    REQUIRE(mng.empty());
+    REQUIRE(silent[0].get_raw() == 1);
+
+    core::normal_emitter::set_coalescing(false);
+
+    core::basic_array<core::normal_emitter> visual{ { 3, 1, 2 } };
+    REQUIRE(visual[0] > visual[1]);
+    visual.swap_at(0, 1);
+    core::normal_emitter::flush();
+
+    std::vector<core::event_data> events(8);
+    REQUIRE(mng.pop(events.data(), events.size()) == 4);
+    REQUIRE(events[0].type == core::event_type::access);
+    REQUIRE(events[1].type == core::event_type::access);
+    REQUIRE(events[2] == core::event_data{ core::event_type::compare, 0, 1 });
+    REQUIRE(events[3] == core::event_data{ core::event_type::swap, 0, 1 });
+    REQUIRE(mng.empty());
+
+    core::normal_emitter::set_coalescing(true);
+}
+
+TEST_CASE("[Array] Accesses are folded into the event that follows them")
+{
+    auto& mng = core::event_manager::instance();
+    REQUIRE(core::normal_emitter::coalescing());
+
+    core::basic_array<core::normal_emitter> visual{ { 3, 1, 2 } };
+    REQUIRE(visual[0].get() > visual[1].get());
+    REQUIRE(visual[0] > visual[1]);
+    REQUIRE(visual[2].get() == 2);
+    visual.swap_at(0, 1);
+    REQUIRE(visual[2].get() == 2);
+    visual.modify(2, 5);
+    REQUIRE(visual[1].get() == 3);
+    visual.end();
+
+    std::vector<core::event_data> events(16);
+    REQUIRE(mng.pop(events.data(), events.size()) == 6);
+    REQUIRE(events[0] == core::event_data{ core::event_type::compare, 0, 1 });
+    REQUIRE(events[1] == core::event_data{ core::event_type::access, 2, 2 });
+    REQUIRE(events[2] == core::event_data{ core::event_type::swap, 0, 1 });
+    REQUIRE(events[3] == core::event_data{ core::event_type::modify, 2, 5 });
+    REQUIRE(events[4] == core::event_data{ core::event_type::access, 1, 3 });
+    REQUIRE(events[5].type == core::event_type::end);
+    REQUIRE(mng.empty());
+}
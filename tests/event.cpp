@@ -2,8 +2,12 @@
 #include <doctest/doctest.h>
 
 #include "event/event.hpp"
+#include "event/playback.hpp"
+#include "event/spsc_queue.hpp"
 
+#include <array>
 #include <chrono>
+#include <limits>
 #include <mutex>
 #include <random>
 #include <thread>
@@ -125,3 +129,230 @@ TEST_CASE("[EventManager] Check if order of pushed/popped events is the same for
     REQUIRE(events == popped_events);
     REQUIRE(mng.empty());
 }
+
+TEST_CASE("[SpscQueue] Bulk push/pop keeps order and respects capacity")
+{
+    constexpr std::size_t capacity = 8;
+    core::spsc_queue<int> queue{ capacity };
+
+    REQUIRE(queue.capacity() == capacity);
+    REQUIRE(queue.empty());
+
+    std::vector<int> const input = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    REQUIRE(queue.try_push(input.data(), input.size()) == capacity);
+    REQUIRE(queue.size() == capacity);
+    REQUIRE_FALSE(queue.try_push(input.back()));
+
+    std::vector<int> output(input.size(), -1);
+    REQUIRE(queue.try_pop(output.data(), 3) == 3);
+    REQUIRE(queue.try_push(input.data() + capacity, 2) == 2);
+    REQUIRE(queue.try_pop(output.data() + 3, output.size()) == 7);
+    REQUIRE(queue.empty());
+
+    int last = -1;
+    REQUIRE_FALSE(queue.try_pop(last));
+    REQUIRE(input == output);
+}
+
+TEST_CASE("[PackedEvent] Events survive a pack/unpack round trip")
+{
+    constexpr core::element_t big = core::element_t{ 1 } << 40U;
+    constexpr core::element_t max = ~core::element_t{ 0 };
+
+    std::vector<core::event_data> const events = {
+        { core::event_type::access, 0, 0 },         { core::event_type::compare, 1'000'000, 1'000'001 },
+        { core::event_type::swap, big, big - 1 },   { core::event_type::swap, big, big + 8'191 },
+        { core::event_type::modify, 5, big },       { core::event_type::compare, max, 0 },
+        { core::event_type::access, max, max },     { core::event_type::end, 0, 0 },
+        { core::event_type::swap, big, big - 8'192 }
+    };
+    std::vector<std::size_t> const expected_sizes = { 1, 1, 1, 1, 3, 3, 3, 1, 1 };
+
+    for(std::size_t k = 0; k < events.size(); ++k) {
+        std::array<core::packed_event, core::max_packed_event_size> words{};
+        auto const size = core::pack(events[k], words.data());
+
+        REQUIRE(size == expected_sizes[k]);
+        REQUIRE(core::packed_size(words[0]) == size);
+
+        core::event_data decoded{};
+        REQUIRE(core::unpack(words.data(), decoded) == size);
+        REQUIRE(decoded == events[k]);
+    }
+
+    auto& mng = core::event_manager::instance();
+    mng.push(events.data(), events.size());
+    mng.flush();
+
+    std::vector<core::event_data> popped(events.size());
+    REQUIRE(mng.pop(popped.data(), popped.size()) == events.size());
+    REQUIRE(events == popped);
+    REQUIRE(mng.empty());
+}
+
+TEST_CASE("[EventManager] The producer waits at the high-water mark")
+{
+    constexpr std::size_t max_queued = 1'024;
+    constexpr core::element_t count = 20'000;
+
+    auto& mng = core::event_manager::instance();
+    mng.set_max_queued(max_queued);
+    REQUIRE(mng.max_queued() == max_queued);
+
+    std::thread t{ [] {
+        for(core::element_t k = 0; k < count; ++k) {
+            core::event_manager::instance().push({ core::event_type::access, k, k });
+        }
+    } };
+
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(15ms);
+    // the producer is blocked at the mark instead of filling the whole ring
+    REQUIRE(mng.size() <= max_queued);
+
+    std::array<core::event_data, 64> popped{};
+    core::element_t expected = 0;
+
+    while(expected < count) {
+        REQUIRE(mng.size() <= max_queued);
+
+        auto const n = mng.pop(popped.data(), popped.size());
+
+        for(std::size_t k = 0; k < n; ++k) {
+            REQUIRE(popped.at(k) == core::event_data{ core::event_type::access, expected, expected });
+            ++expected;
+        }
+    }
+
+    t.join();
+    mng.set_max_queued(core::event_manager::capacity());
+
+    REQUIRE(mng.empty());
+}
+
+TEST_CASE("[EventManager] Events of several producers all arrive in per-thread order")
+{
+    constexpr core::element_t num_producers = 4;
+    constexpr core::element_t count = 50'000;
+
+    auto& mng = core::event_manager::instance();
+    std::vector<std::thread> producers;
+
+    for(core::element_t id = 0; id < num_producers; ++id) {
+        producers.emplace_back([id] {
+            for(core::element_t k = 0; k < count; ++k) {
+                core::event_manager::instance().push({ core::event_type::compare, k, id });
+            }
+        });
+    }
+
+    std::vector<core::element_t> next(num_producers, 0);
+    std::array<core::event_data, 256> popped{};
+    core::element_t total = 0;
+
+    while(total < num_producers * count) {
+        auto const n = mng.pop(popped.data(), popped.size());
+
+        for(std::size_t k = 0; k < n; ++k) {
+            auto const& ev = popped.at(k);
+            REQUIRE(ev.j < num_producers);
+            REQUIRE(ev.i == next.at(ev.j));
+            ++next.at(ev.j);
+        }
+
+        total += n;
+
+        if(n == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    for(auto& t : producers) {
+        t.join();
+    }
+
+    REQUIRE(mng.empty());
+}
+
+TEST_CASE("[EventManager] Accesses held back for coalescing are handed over when the thread exits")
+{
+    auto& mng = core::event_manager::instance();
+    REQUIRE(core::normal_emitter::coalescing());
+
+    std::thread{ [] {
+        core::normal_emitter::on_access(3, 30);
+        core::normal_emitter::on_access(5, 50);
+    } }.join();
+
+    std::array<core::event_data, 4> popped{};
+    REQUIRE(mng.pop(popped.data(), popped.size()) == 2);
+    REQUIRE(popped[0] == core::event_data{ core::event_type::access, 3, 30 });
+    REQUIRE(popped[1] == core::event_data{ core::event_type::access, 5, 50 });
+    REQUIRE(mng.empty());
+}
+
+TEST_CASE("[EventManager] A thread exiting at the high-water mark doesn't wait for the consumer")
+{
+    // two full blocks reach the lowest mark, the partial one handed over at exit goes past it
+    constexpr core::element_t count = 520;
+
+    auto& mng = core::event_manager::instance();
+    mng.set_max_queued(0);
+
+    std::thread{ [] {
+        for(core::element_t k = 0; k < count; ++k) {
+            core::event_manager::instance().push({ core::event_type::access, k, k });
+        }
+    } }.join();
+
+    REQUIRE(mng.size() > mng.max_queued());
+
+    std::array<core::event_data, 64> popped{};
+    core::element_t expected = 0;
+
+    while(expected < count) {
+        auto const n = mng.pop(popped.data(), popped.size());
+        REQUIRE(n > 0);
+
+        for(std::size_t k = 0; k < n; ++k) {
+            REQUIRE(popped.at(k) == core::event_data{ core::event_type::access, expected, expected });
+            ++expected;
+        }
+    }
+
+    mng.set_max_queued(core::event_manager::capacity());
+    REQUIRE(mng.empty());
+}
+
+TEST_CASE("[PlaybackClock] Events become due at the configured rate")
+{
+    using namespace std::chrono_literals;
+
+    auto const start = core::playback_clock::clock::now();
+    core::playback_clock playback{ 1'000.0, start };
+
+    REQUIRE(playback.advance(start) == 0);
+    REQUIRE(playback.advance(start + 10ms) == 10);
+
+    playback.consume(4);
+    REQUIRE(playback.advance(start + 10ms) == 6);
+    playback.consume(6);
+
+    // time spent paused doesn't count
+    playback.reset(start + 1s);
+    REQUIRE(playback.advance(start + 1s + 1ms) == 1);
+    playback.consume(1);
+
+    // a long stall is capped instead of turning into a huge burst
+    REQUIRE(playback.advance(start + 1h) == 250);
+    playback.consume(250);
+
+    playback.faster();
+    REQUIRE(playback.rate() == doctest::Approx(2'000.0));
+    playback.slower();
+    playback.slower();
+    REQUIRE(playback.rate() == doctest::Approx(500.0));
+
+    playback.set_rate(core::playback_clock::unlimited);
+    REQUIRE(playback.advance(start + 1h + 1ms) == std::numeric_limits<std::size_t>::max());
+}
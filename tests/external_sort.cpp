@@ -0,0 +1,212 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "algorithm/algorithm.hpp"
+#include "algorithm/external_sort.hpp"
+#include "event/event.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto const g_input_path = std::string{ "sortvis_test_external.bin" };
+auto const g_output_path = std::string{ "sortvis_test_external.sorted" };
+
+[[nodiscard]] auto read_keys(std::string const& path) -> std::vector<core::element_t>
+{
+    std::ifstream file{ path, std::ios::binary | std::ios::ate };
+    std::vector<core::element_t> keys(static_cast<std::size_t>(file.tellg()) / sizeof(core::element_t));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(keys.data()), // NOLINT
+              static_cast<std::streamsize>(keys.size() * sizeof(core::element_t)));
+
+    return keys;
+}
+
+[[nodiscard]] auto small_config(void (*sort)(core::silent_array&)) -> core::external_sort_config
+{
+    core::external_sort_config cfg{};
+    cfg.input_path = g_input_path;
+    cfg.output_path = g_output_path;
+    // runs of 2048 keys, merged 7 at a time
+    cfg.memory_limit = std::size_t{ 64 } << 10U;
+    cfg.sort = sort;
+    return cfg;
+}
+
+// Sorts the first few runs, then throws.
+auto g_sorts_left = 0;
+
+auto sort_then_throw(core::silent_array& v) -> void
+{
+    if(g_sorts_left-- == 0) {
+        throw std::runtime_error{ "out of sorts" };
+    }
+
+    core::algorithm::pdqsort(v);
+}
+
+} // namespace
+
+TEST_CASE("[External] Sorts a file many times larger than its memory limit")
+{
+    constexpr std::uint64_t size = 100'003;
+
+    core::write_random_keys(g_input_path, size, 7);
+    REQUIRE(core::key_file_size(g_input_path) == size);
+
+    auto expected = read_keys(g_input_path);
+    std::sort(expected.begin(), expected.end());
+
+    for(auto const sort : { &core::algorithm::pdqsort<core::silent_array>,
+                            &core::algorithm::merge_sort<core::silent_array>,
+                            &core::algorithm::radix_sort<core::silent_array> }) {
+        auto const result = core::external_sort(small_config(sort));
+
+        REQUIRE(result.keys == size);
+        REQUIRE(result.runs == 49);
+        REQUIRE(result.merge_passes == 2);
+        REQUIRE(read_keys(g_output_path) == expected);
+        // the runs are gone
+        REQUIRE(std::fopen((g_output_path + ".run0").c_str(), "rb") == nullptr);
+    }
+
+    std::remove(g_input_path.c_str());
+    std::remove(g_output_path.c_str());
+}
+
+TEST_CASE("[External] Samples land where the merges write them")
+{
+    constexpr std::uint64_t size = 30'000;
+    constexpr std::uint64_t stride = 97;
+
+    core::write_random_keys(g_input_path, size, 3);
+
+    auto const input = read_keys(g_input_path);
+    std::vector<core::element_t> formed(size);
+    std::map<std::uint64_t, core::element_t> merged{};
+    std::size_t run_samples = 0;
+
+    auto cfg = small_config(&core::algorithm::pdqsort<core::silent_array>);
+    cfg.sample_stride = stride;
+    cfg.on_sample = [&](core::external_phase const phase, std::uint64_t const position, core::element_t const key) {
+        REQUIRE(position % stride == 0);
+
+        if(phase == core::external_phase::run_formation) {
+            formed[position] = key;
+            ++run_samples;
+        }
+        else {
+            merged[position] = key;
+        }
+    };
+
+    auto const result = core::external_sort(cfg);
+    auto const output = read_keys(g_output_path);
+
+    REQUIRE(result.merge_passes == 2);
+    REQUIRE(run_samples == (size + stride - 1) / stride);
+    REQUIRE(merged.size() == run_samples);
+
+    // every run keeps the keys read from where it's written
+    constexpr std::uint64_t run_size = 2048;
+
+    for(std::uint64_t first = 0; first < size; first += run_size) {
+        auto const last = std::min(first + run_size, size);
+        std::vector<core::element_t> run(input.begin() + static_cast<std::ptrdiff_t>(first),
+                                         input.begin() + static_cast<std::ptrdiff_t>(last));
+        std::sort(run.begin(), run.end());
+
+        for(auto position = (first + stride - 1) / stride * stride; position < last; position += stride) {
+            REQUIRE(formed[position] == run[position - first]);
+        }
+    }
+
+    // the final merge writes last
+    for(auto const& [position, key] : merged) {
+        REQUIRE(output[position] == key);
+    }
+
+    REQUIRE(core::sample_key_file(g_output_path, 10) ==
+            std::vector<core::element_t>{ output[0], output[3'000], output[6'000], output[9'000], output[12'000],
+                                          output[15'000], output[18'000], output[21'000], output[24'000],
+                                          output[27'000] });
+
+    std::remove(g_input_path.c_str());
+    std::remove(g_output_path.c_str());
+}
+
+TEST_CASE("[External] A sort that throws leaves no runs behind")
+{
+    core::write_random_keys(g_input_path, 100'003, 3);
+    g_sorts_left = 3;
+
+    bool thrown = false;
+
+    try {
+        static_cast<void>(core::external_sort(small_config(&sort_then_throw)));
+    }
+    catch(std::runtime_error const&) {
+        thrown = true;
+    }
+
+    REQUIRE(thrown);
+
+    for(auto const* const run : { ".run0", ".run1", ".run2" }) {
+        REQUIRE(std::fopen((g_output_path + run).c_str(), "rb") == nullptr);
+    }
+
+    std::remove(g_input_path.c_str());
+}
+
+TEST_CASE("[External] Empty files, single runs and missing files")
+{
+    auto cfg = small_config(&core::algorithm::pdqsort<core::silent_array>);
+
+    core::write_random_keys(g_input_path, 0, 1);
+    REQUIRE(core::external_sort(cfg).runs == 0);
+    REQUIRE(core::key_file_size(g_output_path) == 0);
+
+    core::write_random_keys(g_input_path, 1'000, 1);
+    auto expected = read_keys(g_input_path);
+    std::sort(expected.begin(), expected.end());
+
+    auto const result = core::external_sort(cfg);
+    REQUIRE(result.runs == 1);
+    REQUIRE(result.merge_passes == 0);
+    REQUIRE(read_keys(g_output_path) == expected);
+
+    std::remove(g_input_path.c_str());
+    std::remove(g_output_path.c_str());
+
+    bool missing_thrown = false;
+
+    try {
+        static_cast<void>(core::external_sort(cfg));
+    }
+    catch(std::runtime_error const&) {
+        missing_thrown = true;
+    }
+
+    REQUIRE(missing_thrown);
+
+    bool unsorted_thrown = false;
+    cfg.sort = nullptr;
+
+    try {
+        static_cast<void>(core::external_sort(cfg));
+    }
+    catch(std::invalid_argument const&) {
+        unsorted_thrown = true;
+    }
+
+    REQUIRE(unsorted_thrown);
+}
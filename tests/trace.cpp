@@ -0,0 +1,135 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "event/event.hpp"
+#include "event/trace.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto const g_trace_path = std::string{ "sortvis_test_trace.bin" };
+
+[[nodiscard]] auto pack_all(std::vector<core::event_data> const& events) -> std::vector<core::packed_event>
+{
+    std::vector<core::packed_event> words;
+
+    for(auto const& event : events) {
+        std::array<core::packed_event, core::max_packed_event_size> buffer{};
+        auto const size = core::pack(event, buffer.data());
+        words.insert(words.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+
+    return words;
+}
+
+} // namespace
+
+TEST_CASE("[Trace] Header, initial data and events survive a write/read round trip")
+{
+    core::trace_info const info{ "quicksort", 42, { 3, 1, 2, 5, 4 } };
+    std::vector<core::event_data> const events = { { core::event_type::compare, 0, 1 },
+                                                   { core::event_type::swap, 0, 1 },
+                                                   { core::event_type::modify, 2, ~core::element_t{ 0 } },
+                                                   { core::event_type::end, 0, 0 } };
+    auto const words = pack_all(events);
+
+    {
+        core::trace_writer writer{ g_trace_path, info };
+        writer.write(words.data(), 2);
+        writer.write(words.data() + 2, words.size() - 2);
+    }
+
+    core::trace_reader reader{ g_trace_path };
+
+    REQUIRE(reader.info().algorithm == info.algorithm);
+    REQUIRE(reader.info().seed == info.seed);
+    REQUIRE(reader.info().initial_data == info.initial_data);
+
+    std::vector<core::event_data> read(events.size() + 1);
+    REQUIRE(reader.read(read.data(), 3) == 3);
+    REQUIRE(!reader.done());
+    REQUIRE(reader.read(read.data() + 3, read.size() - 3) == 1);
+    REQUIRE(reader.done());
+
+    read.pop_back();
+    REQUIRE(read == events);
+
+    std::remove(g_trace_path.c_str());
+}
+
+TEST_CASE("[Trace] A trace cut short in the middle of an event stops before it")
+{
+    core::trace_info const info{ "merge_sort", 7, { 2, 1 } };
+    std::vector<core::event_data> const events = { { core::event_type::access, 0, 2 },
+                                                   { core::event_type::modify, 1, ~core::element_t{ 0 } } };
+    auto const words = pack_all(events);
+
+    {
+        core::trace_writer writer{ g_trace_path, info };
+        writer.write(words.data(), words.size() - 1);
+    }
+
+    core::trace_reader reader{ g_trace_path };
+    std::vector<core::event_data> read(events.size());
+
+    REQUIRE(reader.read(read.data(), read.size()) == 1);
+    REQUIRE(read.front() == events.front());
+    REQUIRE(reader.done());
+
+    std::remove(g_trace_path.c_str());
+}
+
+TEST_CASE("[Trace] Files that aren't traces are rejected")
+{
+    {
+        std::ofstream file{ g_trace_path, std::ios::binary };
+        file << "definitely not a trace, but long enough to hold a whole trace header......";
+    }
+
+    bool thrown = false;
+
+    try {
+        core::trace_reader reader{ g_trace_path };
+    }
+    catch(std::runtime_error const&) {
+        thrown = true;
+    }
+
+    REQUIRE(thrown);
+    std::remove(g_trace_path.c_str());
+}
+
+TEST_CASE("[Trace] A header claiming more keys than the file holds is truncated")
+{
+    {
+        core::trace_writer writer{ g_trace_path, core::trace_info{ "pdqsort", 1, { 1, 2 } } };
+    }
+
+    // times sizeof(element_t) this wraps around to 8 bytes, which the file does hold
+    core::element_t const size = (~core::element_t{ 0 } / sizeof(core::element_t)) + 2;
+
+    {
+        std::fstream file{ g_trace_path, std::ios::binary | std::ios::in | std::ios::out };
+        file.seekp(static_cast<std::streamoff>(offsetof(core::trace_header, size)));
+        file.write(reinterpret_cast<char const*>(&size), sizeof(size)); // NOLINT
+    }
+
+    bool truncated = false;
+
+    try {
+        core::trace_reader reader{ g_trace_path };
+    }
+    catch(std::runtime_error const& e) {
+        truncated = std::string{ e.what() }.find("truncated") != std::string::npos;
+    }
+
+    REQUIRE(truncated);
+    std::remove(g_trace_path.c_str());
+}